@@ -0,0 +1,485 @@
+// Headless checks for the engine's span writers and layer uploads, the software renderer, the text cache, compiled
+// sprites and the pipelined renderer. The whole game is built in without a window or GPU, composited by the software
+// renderer, and the program exits with the number of checks that failed, so a script can run it:
+//
+//   g++ -std=c++14 -O2 Tests.cpp -o Tests -lpthread -lstdc++fs && ./Tests [frames]
+//
+#define OLC_PGE_HEADLESS
+#define OLC_GFX_SOFTWARE
+#define WORMS_NO_MAIN
+#include "Worms.cpp"
+
+static int nFailures = 0;
+
+static void Check(bool bPassed, const string& sWhat)
+{
+	cout << (bPassed ? "ok   " : "FAIL ") << sWhat << endl;
+	if (!bPassed)
+		nFailures++;
+}
+
+// Every span writer does four pixels at a time with SSE2 and the rest one by one. Rows of every length up to a few
+// blocks, at every alignment, must come out exactly as the single pixel functions give, and nothing past them may change
+static void CheckSpanWriters()
+{
+	mt19937 rng(1);
+	auto RandomAlpha = [&]() { return rng() % 4 == 0 ? (rng() % 2) * 255 : rng() % 256; };		// Often fully see-through or opaque
+	auto RandomPixel = [&]() { return olc::Pixel((uint8_t)rng(), (uint8_t)rng(), (uint8_t)rng(), (uint8_t)RandomAlpha()); };
+
+	olc::Pixel p;		// The colour, alpha and blend factor are picked again for every row
+	uint32_t a = 0, nBlend = 0;
+	vector<olc::Pixel> vecDest(48), vecSource(48), vecExpected(48);
+	auto CheckWriter = [&](const string& sName, function<void(olc::Pixel*, const olc::Pixel*, int32_t)> funcRow,
+		function<olc::Pixel(olc::Pixel, olc::Pixel)> funcPixel)		// funcPixel is given the source and destination pixel
+	{
+		int nMismatches = 0;
+		for (int nRun = 0; nRun < 20000; nRun++)
+		{
+			p = RandomPixel();
+			a = RandomAlpha();
+			nBlend = RandomAlpha();
+			int nStart = rng() % 4;
+			int nCount = rng() % 41;
+			for (auto& d : vecDest) d = RandomPixel();
+			for (auto& s : vecSource) s = RandomPixel();
+			vecExpected = vecDest;
+			for (int i = nStart; i < nStart + nCount; i++)
+				vecExpected[i] = funcPixel(vecSource[i], vecDest[i]);
+			funcRow(vecDest.data() + nStart, vecSource.data() + nStart, nCount);
+			if (vecDest != vecExpected)
+				nMismatches++;
+		}
+		Check(nMismatches == 0, sName + " matches its single pixel function");
+	};
+
+	CheckWriter("FillRow", [&](olc::Pixel* d, const olc::Pixel*, int32_t n) { olc::span::FillRow(d, n, p); },
+		[&](olc::Pixel, olc::Pixel) { return p; });
+	CheckWriter("BlendRow", [&](olc::Pixel* d, const olc::Pixel*, int32_t n) { olc::span::BlendRow(d, n, 1, p, a); },
+		[&](olc::Pixel, olc::Pixel d) { return olc::span::Blend(p, d, a); });
+	CheckWriter("BlendRow from a sprite", [&](olc::Pixel* d, const olc::Pixel* s, int32_t n) { olc::span::BlendRow(d, s, n, nBlend); },
+		[&](olc::Pixel s, olc::Pixel d) { return olc::span::Blend(s, d, olc::span::BlendAlpha(s, nBlend)); });
+	CheckWriter("OverRow", [&](olc::Pixel* d, const olc::Pixel*, int32_t n) { olc::span::OverRow(d, n, 1, p, a); },
+		[&](olc::Pixel, olc::Pixel d) { return olc::span::Over(p, d, a); });
+	CheckWriter("ModulateRow", [&](olc::Pixel* d, const olc::Pixel*, int32_t n) { olc::span::ModulateRow(d, n, p); },
+		[&](olc::Pixel, olc::Pixel d) { return olc::span::Modulate(d, p); });
+	CheckWriter("AddRow", [&](olc::Pixel* d, const olc::Pixel* s, int32_t n) { olc::span::AddRow(d, s, n); },
+		[&](olc::Pixel s, olc::Pixel d) { return olc::span::Add(s, d); });
+
+	vector<olc::Pixel> vecPalette(256);		// The source pixels' red channel stands in for the palette indices
+	for (auto& c : vecPalette) c = RandomPixel();
+	vector<uint8_t> vecIndices;
+	CheckWriter("ExpandRow", [&](olc::Pixel* d, const olc::Pixel* s, int32_t n)
+		{
+			vecIndices.resize(n);
+			for (int32_t i = 0; i < n; i++) vecIndices[i] = s[i].r;
+			olc::span::ExpandRow(d, vecIndices.data(), n, vecPalette.data());
+		},
+		[&](olc::Pixel s, olc::Pixel) { return vecPalette[s.r]; });
+}
+
+static vector<float> WormStates(cMatch& m)		// Where every worm is and how healthy, to tell whether two matches played out the same
+{
+	vector<float> vecStates;
+	m.poolWorms.ForEachAlive([&](cWorm& w) { vecStates.insert(vecStates.end(), { (float)w.px, (float)w.py, (float)w.fHealth }); });
+	return vecStates;
+}
+
+// Parts of the match's physics, driven directly on an empty map rather than through a whole game
+class cMatchTest
+{
+public:
+	// A missile moving tens of pixels per step must still stop at a wall one pixel thick
+	static void CheckSweep()
+	{
+		cMatch match;
+		for (int y = 0; y < match.nMapHeight; y++)
+			match.map[y * match.nMapWidth + 500] = 1;
+		cMissile* m = match.Spawn(match.poolMissiles, 401.5f, 256.0f, 2000.0f, 0.0f);
+		match.UpdateObjectList();
+
+		float fFurthest = 0.0f;
+		for (int f = 0; f < 10 && !m->bDead; f++)
+		{
+			match.UpdatePhysics(1.0f / 60.0f);
+			fFurthest = max(fFurthest, (float)m->px);
+		}
+		Check(m->bDead && fFurthest < 500.0f && match.stats.nExplosions == 1, "fast missiles hit thin terrain instead of passing through it");
+	}
+
+	// Objects join the list at the end of the update they're spawned in and leave it at the end of the one they die
+	// in, and a dead object's slot is what the next object of its type is made in
+	static void CheckObjectList()
+	{
+		cMatch match;
+		auto InList = [&](cPhysicsObject* p) { return find(match.vecObjects.begin(), match.vecObjects.end(), p) != match.vecObjects.end(); };
+
+		cDebris* pFirst = match.Spawn(match.poolDebris, 10.0f, 10.0f);
+		bool bDeferred = !InList(pFirst);
+		match.UpdateObjectList();
+		bDeferred = bDeferred && InList(pFirst);
+
+		match.pCameraTrackingObject = pFirst;
+		pFirst->bDead = true;
+		bDeferred = bDeferred && InList(pFirst);
+		match.UpdateObjectList();
+		Check(bDeferred && !InList(pFirst) && match.pCameraTrackingObject == nullptr, "objects join and leave the list at the end of an update");
+
+		cDebris* pSecond = match.Spawn(match.poolDebris, 20.0f, 20.0f);
+		Check(pSecond == pFirst && !pSecond->bDead && pSecond->px == 20.0f, "dead objects' slots are reused");
+	}
+
+	// Events come out in the order they went in, across the end of the array, and ones that don't fit are counted
+	static void CheckEventQueue()
+	{
+		cRingBuffer<int, 4> queue;
+		bool bOrdered = queue.Push(1) && queue.Push(2) && queue.Push(3) && queue.Push(4) && !queue.Push(5);
+		int n = 0;
+		bOrdered = bOrdered && queue.Pop(n) && n == 1 && queue.Pop(n) && n == 2 && queue.Push(5) && queue.Push(6);
+		for (int nExpected = 3; nExpected <= 6; nExpected++)
+			bOrdered = bOrdered && queue.Pop(n) && n == nExpected;
+		Check(bOrdered && !queue.Pop(n) && queue.Size() == 0, "event queue is first in, first out across its wraparound");
+
+		cMatch match;
+		for (int i = 0; i < 1025; i++)
+			match.PushEvent({ sPhysicsEvent::EVT_BOUNCE, nullptr, 0.0f, 0.0f, 1.0f });
+		match.HandlePhysicsEvents();
+		Check(match.stats.nEventsDropped == 1 && match.stats.nBounces == 1024, "events beyond the queue's capacity are dropped and counted");
+	}
+
+	// Objects take just enough of a frame's iterations to move no more than their radius in each, resting objects
+	// sleep, and an explosion wakes sleepers without giving objects that are already awake extra steps
+	static void CheckSubsteps()
+	{
+		cMatch match;
+		auto Substeps = [&](float vx, bool bResting)
+		{
+			cMissile m(100.0f, 100.0f, vx, 0.0f);
+			m.radius = 4.0f;		// At 60 fps, every 24 pixels per second of speed then needs another substep
+			m.bStable = bResting;
+			m.bTouchingTerrain = bResting;
+			return match.ChooseSubsteps(&m, 1.0f / 60.0f);
+		};
+		Check(Substeps(0.0f, true) == 0 && Substeps(0.0f, false) == 1 && Substeps(12.0f, false) == 1 && Substeps(40.0f, false) == 2
+			&& Substeps(60.0f, false) == 5 && Substeps(300.0f, false) == 10, "substeps follow speed, and resting objects sleep");
+
+		cDebris* pAsleep = match.Spawn(match.poolDebris, 100.0f, 100.0f);
+		cDebris* pAwake = match.Spawn(match.poolDebris, 102.0f, 100.0f);
+		match.UpdateObjectList();
+		pAsleep->nSubsteps = 0;
+		pAwake->nSubsteps = 2;
+		match.Boom(101.0f, 100.0f, 5.0f);
+		Check(pAsleep->nSubsteps == 10 && pAwake->nSubsteps == 2 && !pAsleep->bStable, "explosions wake sleeping objects only");
+	}
+};
+
+// A match only depends on its seed and frame times: matches played side by side on a thread pool must come out the
+// same as when played one after another, and different seeds must give different matches
+static void CheckMatchRunner()
+{
+	struct sOutcome
+	{
+		vector<char> map;
+		vector<float> vecWorms;
+		float fMatchTime;
+		int nExplosions;
+		bool operator == (const sOutcome& o) const { return map == o.map && vecWorms == o.vecWorms && fMatchTime == o.fMatchTime && nExplosions == o.nExplosions; }
+	};
+	auto Play = [](unsigned int nSeed, sOutcome& outcome)
+	{
+		unique_ptr<cMatch> match(new cMatch(nSeed));
+		match->bHumanPlayer = false;
+		mt19937 rngFrames(nSeed);
+		uniform_real_distribution<float> distFrameTime(0.9f / 60.0f, 1.1f / 60.0f);
+		for (int f = 0; f < 4000 && !match->IsOver(); f++)
+			match->Update(distFrameTime(rngFrames), sPlayerInput());
+		outcome = { match->map, WormStates(*match), match->GetMatchTime(), match->stats.nExplosions };
+	};
+
+	const int nMatches = 4;
+	vector<sOutcome> vecAlone(nMatches), vecSideBySide(nMatches);
+	for (int i = 0; i < nMatches; i++)
+		Play(1 + i, vecAlone[i]);
+	cThreadPool pool(nMatches);
+	for (int i = 0; i < nMatches; i++)
+		pool.Submit([&, i]() { Play(1 + i, vecSideBySide[i]); });
+	pool.Wait();
+
+	Check(vecAlone == vecSideBySide, "matches played on a thread pool come out the same as played alone");
+	Check(!(vecAlone[0] == vecAlone[1]) && vecAlone[0].nExplosions > 0, "matches with different seeds play out differently");
+}
+
+// Fixed point numbers stick at their limits instead of wrapping round, and dividing by zero gives the largest number of
+// the right sign. A frame too short for a physics tick still puts what it spawned in play, so the match isn't taken
+// for stable with a missile in flight
+static void CheckFixedPoint()
+{
+	Check(cFixed(40000.0f).n == INT32_MAX && cFixed(-1e9).n == INT32_MIN && cFixed(70000).n == INT32_MAX && cFixed(2.5f).n == 0x28000,
+		"fixed point numbers saturate out of range");
+	Check(cFixed(3) / cFixed(0) == cFixed::FromRaw(INT32_MAX) && cFixed(-3) / cFixed(0) == cFixed::FromRaw(INT32_MIN)
+		&& cFixed(30000) * cFixed(4) == cFixed::FromRaw(INT32_MAX), "fixed point division by zero and overflow saturate");
+
+	cMatch match;
+	match.Update(0.0f, sPlayerInput());
+	cMissile* m = match.Spawn(match.poolMissiles, 100.0f, 100.0f, 10.0f, 0.0f);
+	match.Update(0.0f, sPlayerInput());
+	Check(find(match.vecObjects.begin(), match.vecObjects.end(), m) != match.vecObjects.end(), "objects spawned in a frame with no physics tick join the match");
+}
+
+// The text cache has to draw exactly what DrawString does, both before a string is compiled and after, at any scale
+// and wherever the text is cut off by the edges of the target
+static void CheckTextCache(olc::PixelGameEngine& engine)
+{
+	cTextCache text;
+	text.SetFont(engine.GetFontSprite());
+	olc::Sprite sprEngine(200, 120), sprCache(200, 120);
+	const char* sTexts[] = { "FPS     60", "HELLO\nworld!", "-35", "a\tb", "~{}|", "" };
+
+	mt19937 rng(2);
+	int nMismatches = 0;
+	for (int t = 0; t < 3000; t++)
+	{
+		string sText = sTexts[rng() % 6];
+		int x = (int)(rng() % 260) - 40, y = (int)(rng() % 170) - 30, nScale = 1 + rng() % 3;
+		olc::Pixel col((uint8_t)rng(), (uint8_t)rng(), (uint8_t)rng());
+		for (int nDraw = 0; nDraw < 2; nDraw++)		// The second time round, the string is drawn compiled
+		{
+			fill(sprEngine.pColData.begin(), sprEngine.pColData.end(), olc::BLACK);
+			fill(sprCache.pColData.begin(), sprCache.pColData.end(), olc::BLACK);
+			engine.SetDrawTarget(&sprEngine);
+			engine.DrawString(x, y, sText, col, nScale);
+			text.Draw({ &sprCache, 0, sprCache.height }, x, y, sText, col, nScale);
+			if (sprEngine.pColData != sprCache.pColData)
+				nMismatches++;
+		}
+		text.EndFrame();
+	}
+	engine.SetDrawTarget(nullptr);
+	Check(nMismatches == 0, "text cache draws the same as DrawString");
+}
+
+// A compiled sprite has to draw a cell exactly as DrawPartialSprite does in MASK mode, at any scale and flip, cut off by
+// the edges of the target, and split across bands the way the drawing threads split the screen
+static void CheckCompiledSprites(olc::PixelGameEngine& engine)
+{
+	mt19937 rng(3);
+	olc::Sprite sprSheet(32, 16);
+	for (olc::Pixel& p : sprSheet.pColData)
+		p = rng() % 3 == 0 ? olc::Pixel((uint8_t)rng(), 0, 0, (uint8_t)(rng() % 255)) : olc::Pixel((uint8_t)rng(), (uint8_t)rng(), (uint8_t)rng());
+	cCompiledSprite sprite(&sprSheet, 8, 8);
+
+	olc::Sprite sprEngine(64, 48), sprCompiled(64, 48);
+	const uint8_t nFlips[] = { olc::Sprite::NONE, olc::Sprite::HORIZ, olc::Sprite::VERT, olc::Sprite::HORIZ | olc::Sprite::VERT };
+	int nMismatches = 0;
+	engine.SetPixelMode(olc::Pixel::MASK);
+	for (int t = 0; t < 3000; t++)
+	{
+		int x = (int)(rng() % 100) - 30, y = (int)(rng() % 80) - 24, cx = rng() % 4, cy = rng() % 2, nScale = 1 + rng() % 3;
+		uint8_t nFlip = nFlips[rng() % 4];
+		int nSplit = rng() % (sprCompiled.height + 1);
+
+		fill(sprEngine.pColData.begin(), sprEngine.pColData.end(), olc::BLACK);
+		fill(sprCompiled.pColData.begin(), sprCompiled.pColData.end(), olc::BLACK);
+		engine.SetDrawTarget(&sprEngine);
+		engine.DrawPartialSprite(x, y, &sprSheet, cx * 8, cy * 8, 8, 8, nScale, nFlip);
+		sprite.DrawCell({ &sprCompiled, 0, nSplit }, x, y, cx, cy, nScale, nFlip);
+		sprite.DrawCell({ &sprCompiled, nSplit, sprCompiled.height }, x, y, cx, cy, nScale, nFlip);
+		if (sprEngine.pColData != sprCompiled.pColData)
+			nMismatches++;
+	}
+	engine.SetPixelMode(olc::Pixel::NORMAL);
+	engine.SetDrawTarget(nullptr);
+	Check(nMismatches == 0, "compiled sprites draw the same as DrawPartialSprite");
+}
+
+// Pixels plotted one at a time and primitives that mark their own regions can be drawn to a layer in the same frame:
+// what's uploaded must still be everything that changed, and no more of the layer than that
+class cUploadTest : public olc::PixelGameEngine
+{
+private:
+	bool OnUserCreate() override
+	{
+		return true;
+	}
+
+	bool OnUserUpdate(float fElapsedTime) override
+	{
+		olc::Sprite* pLayer = GetDrawTarget();
+		olc::Sprite sprTexture;
+		olc::renderer->ReadTexture(GetLayers()[0].pDrawTarget.Decal()->id, &sprTexture);
+		uint32_t nFullLayer = uint32_t(pLayer->width * pLayer->height * sizeof(olc::Pixel));
+
+		switch (nFrame++)
+		{
+		case 0:
+			Clear(olc::BLACK);
+			return true;
+		case 1:
+			Draw(10, 10, olc::RED);
+			FillRect(100, 100, 4, 4, olc::GREEN);
+			return true;
+		case 2:
+			Check(sprTexture.pColData == pLayer->pColData, "pixels plotted with Draw are uploaded alongside a FillRect");
+			Check(GetUploadedBytes() > 0 && GetUploadedBytes() < nFullLayer, "a frame that changed a few pixels uploads less than the whole layer");
+			Draw(200, 150, olc::BLUE);
+			return true;
+		default:
+			Check(sprTexture.pColData == pLayer->pColData && GetUploadedBytes() == sizeof(olc::Pixel), "a single plotted pixel uploads just that pixel");
+			return false;
+		}
+	}
+
+	int nFrame = 0;
+};
+
+// The software renderer stacks the layers bottom up, blending each over the ones below, and draws a layer's decals
+// over that layer. A frame is composited after OnUserUpdate returns, so it is looked at on the next frame
+class cRendererTest : public olc::PixelGameEngine
+{
+private:
+	bool OnUserCreate() override
+	{
+		uint8_t nBackground = (uint8_t)CreateLayer();
+		EnableLayer(nBackground, true);
+		SetDrawTarget(nBackground);
+		Clear(olc::RED);
+
+		SetDrawTarget(nullptr);
+		Clear(olc::BLANK);
+		FillRect(10, 10, 20, 20, olc::GREEN);
+		Draw(50, 50, olc::Pixel(0, 0, 255, 128));		// Plotted as it is, to be blended when composited
+		return true;
+	}
+
+	bool OnUserUpdate(float fElapsedTime) override
+	{
+		if (nFrame++ == 0)
+		{
+			FillRectDecal({ 100.0f, 60.0f }, { 20.0f, 20.0f }, olc::Pixel(255, 255, 255, 128));
+			return true;
+		}
+
+		const olc::Sprite* pFrame = olc::Renderer_Software::GetFrameBuffer();
+		auto Near = [&](int x, int y, olc::Pixel p)
+		{
+			olc::Pixel q = pFrame->GetPixel(x, y);
+			return abs(q.r - p.r) <= 1 && abs(q.g - p.g) <= 1 && abs(q.b - p.b) <= 1;
+		};
+		Check(pFrame != nullptr && pFrame->width == ScreenWidth() && pFrame->height == ScreenHeight(), "software renderer composites a frame the size of the screen");
+		if (pFrame == nullptr)
+			return false;
+		Check(Near(5, 5, olc::RED) && Near(150, 110, olc::RED), "lower layer shows through where the top layer is blank");
+		Check(Near(10, 10, olc::GREEN) && Near(29, 29, olc::GREEN) && Near(30, 30, olc::RED), "opaque pixels of the top layer cover the layer below");
+		Check(Near(50, 50, olc::Pixel(127, 0, 128)), "translucent layer pixels blend with the layer below");
+		Check(Near(110, 70, olc::Pixel(255, 127, 127)) && Near(98, 70, olc::RED) && Near(121, 70, olc::RED), "translucent decals blend over their layer");
+		return false;
+	}
+
+	int nFrame = 0;
+};
+
+// There's no image decoder without a platform, so the worm sprite sheet is made up: cells of opaque and blank pixels
+class cTestImageLoader : public olc::ImageLoader
+{
+public:
+	olc::rcode LoadImageResource(olc::Sprite* spr, const std::string& sImageFile, olc::ResourcePack* pack) override
+	{
+		spr->width = 32;
+		spr->height = 16;
+		spr->pColData.assign(spr->width * spr->height, olc::Pixel(200, 100, 50));
+		for (size_t i = 0; i < spr->pColData.size(); i += 3)
+			spr->pColData[i] = olc::BLANK;
+		return olc::OK;
+	}
+
+	olc::rcode SaveImageResource(olc::Sprite* spr, const std::string& sImageFile) override { return olc::OK; }
+};
+
+// The game as it runs, with the AI playing every team. Before each frame is drawn, every layer's texture must hold
+// what the layer held when it was last uploaded. At the end the terrain layer must hold the map, and the match played
+// on its own thread must have come out exactly as one stepped on this thread with the same frame times
+class cWormsTest : public Worms
+{
+public:
+	cWormsTest(int nFramesToRun)
+	{
+		nFrames = nFramesToRun;
+		match.bHumanPlayer = false;
+		reference.bHumanPlayer = false;
+		bShowProfiler = true;		// So there's text on the HUD layer too
+	}
+
+	void CheckResults()		// Once Start has returned
+	{
+		Check(nTextureMismatches == 0, "layer textures match the layers over " + to_string(nFrame) + " frames");
+
+		pFrame = &frames[nBackFrame];		// The last frame simulated was never drawn
+		UpdateTerrain();
+		Check(memcmp(GetLayerIndices(nLayerTerrain), match.map.data(), match.map.size()) == 0, "terrain layer holds the map");
+
+		Check(match.map == reference.map && WormStates(match) == WormStates(reference) && match.GetMatchTime() == reference.GetMatchTime(),
+			"simulating alongside drawing plays the match the same as on its own");
+	}
+
+private:
+	bool OnUserCreate() override
+	{
+		CheckTextCache(*this);
+		CheckCompiledSprites(*this);
+		return Worms::OnUserCreate();
+	}
+
+	bool OnUserUpdate(float fElapsedTime) override
+	{
+		if (nFrame > 0)		// Layers are compared once they've been uploaded
+			for (olc::LayerDesc& l : GetLayers())
+			{
+				if (!l.bShow)
+					continue;
+				olc::Sprite sprTexture;
+				olc::renderer->ReadTexture(l.pDrawTarget.Decal()->id, &sprTexture);
+				if (sprTexture.pColData != l.pDrawTarget.Sprite()->pColData)
+					nTextureMismatches++;
+			}
+
+		// Frame times wobble as they do in a window, as in the match runner
+		fElapsedTime = distFrameTime(rngFrames);
+		reference.Update(fElapsedTime, sPlayerInput());
+		return Worms::OnUserUpdate(fElapsedTime) && ++nFrame < nFrames;
+	}
+
+	int nFrames = 0;
+	int nFrame = 0;
+	int nTextureMismatches = 0;
+	cMatch reference;		// Same seed as the game's match
+	mt19937 rngFrames{ 1 };
+	uniform_real_distribution<float> distFrameTime{ 0.9f / 60.0f, 1.1f / 60.0f };
+};
+
+int main(int argc, char* argv[])
+{
+	CheckSpanWriters();
+	cMatchTest::CheckSweep();
+	cMatchTest::CheckObjectList();
+	cMatchTest::CheckEventQueue();
+	cMatchTest::CheckSubsteps();
+	CheckMatchRunner();
+	CheckFixedPoint();
+
+	cUploadTest upload;
+	if (!upload.Construct(320, 200, 1, 1) || upload.Start() != olc::OK)
+		Check(false, "engine starts headless");
+
+	cRendererTest renderer;
+	if (!renderer.Construct(160, 120, 1, 1) || renderer.Start() != olc::OK)
+		Check(false, "engine starts headless");
+
+	cWormsTest game(argc >= 2 ? atoi(argv[1]) : 3000);
+	olc::Sprite::loader.reset(new cTestImageLoader());
+	if (game.Construct(640, 400, 2, 2) && game.Start() == olc::OK)
+		game.CheckResults();
+	else
+		Check(false, "engine starts headless");
+
+	cout << (nFailures == 0 ? "All checks passed" : to_string(nFailures) + " checks failed") << endl;
+	return nFailures;
+}
@@ -1,88 +1,791 @@
 #include <iostream>
 #include <string>
 #include <algorithm>
+#include <deque>
+#include <random>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <functional>
+#include <chrono>
+#include <memory>
 
 using namespace std;
 
 #define OLC_PGE_APPLICATION
 #include "olcPixelGameEngine.h"
 
-// Port DrawWireFrameModel function from Console Game Engine
-void DrawWireFrameModel(olc::PixelGameEngine* engine, const vector<pair<float, float>>& vecModelCoordinates,
-	float x, float y, float r = 0.0f, float s = 1.0f, olc::Pixel col = olc::WHITE)
+// Physics numbers. Physics runs in float by default; defining WORMS_FIXED_POINT switches the physics objects' state,
+// their integration, collision and Boom to 16.16 fixed point with table based trigonometry. Only object physics is
+// covered: turn time, aiming, charging and the AI still work in float from the frame time, so whole matches are not
+// guaranteed to play out the same on every compiler and CPU
+//#define WORMS_FIXED_POINT
+
+const int nAngleSteps = 1024;		// Binary angles split a full turn into 1024 steps, so wrapping an angle is a mask
+
+// Sine by Taylor series, only used by the compiler to build the trig tables below
+constexpr double TaylorSine(double x)
+{
+	double fTerm = x;
+	double fSum = x;
+	for (int n = 1; n < 12; n++)
+	{
+		fTerm *= -x * x / (double)((2 * n) * (2 * n + 1));
+		fSum += fTerm;
+	}
+	return fSum;
+}
+
+struct sSineTable		// sin() of every binary angle, in 16.16 fixed point
+{
+	int32_t nValue[nAngleSteps];
+};
+
+struct sTangentTable		// tan() of the binary angles in the first octant, in 16.16 fixed point
+{
+	int32_t nValue[nAngleSteps / 8 + 1];
+};
+
+constexpr int32_t RoundToRaw(double f)
 {
-	// vecModelCoordinates : the wire frame model
-	// x, y : the screenposition where to draw it
-	// r : angle of rotation
-	// s : scaling factor
+	return (int32_t)(f < 0.0 ? f * 65536.0 - 0.5 : f * 65536.0 + 0.5);
+}
 
-	// Create translated model vector of coordinate pairs
-	vector<pair<float, float>> vecTransformedCoordinates;		// pair.first : x coordinate, pair.second : y coordinate
-	int verts = vecModelCoordinates.size();				// Keep the model vector static
-	vecTransformedCoordinates.resize(verts);			// Create another vector the same size as the model vector
+constexpr sSineTable MakeSineTable()
+{
+	sSineTable table = {};
+	for (int i = 0; i < nAngleSteps; i++)
+	{
+		// Angles past a half turn are evaluated as negative angles, which keeps the series accurate
+		int nSigned = i < nAngleSteps / 2 ? i : i - nAngleSteps;
+		table.nValue[i] = RoundToRaw(TaylorSine(6.283185307179586 * (double)nSigned / (double)nAngleSteps));
+	}
+	return table;
+}
 
-	// Rotates
-	for (int i = 0; i < verts; i++)
+constexpr sTangentTable MakeTangentTable()
+{
+	sTangentTable table = {};
+	for (int i = 0; i <= nAngleSteps / 8; i++)
 	{
-		vecTransformedCoordinates[i].first = vecModelCoordinates[i].first * cosf(r) - vecModelCoordinates[i].second * sinf(r);
-		vecTransformedCoordinates[i].second = vecModelCoordinates[i].first * sinf(r) + vecModelCoordinates[i].second * cosf(r);
+		double fAngle = 6.283185307179586 * (double)i / (double)nAngleSteps;
+		table.nValue[i] = RoundToRaw(TaylorSine(fAngle) / TaylorSine(1.5707963267948966 - fAngle));
 	}
+	return table;
+}
 
-	// Scales
-	for (int i = 0; i < verts; i++)
+// Built at compile time, so every build gets exactly the same tables
+constexpr sSineTable tableSine = MakeSineTable();
+constexpr sTangentTable tableTangent = MakeTangentTable();
+
+inline int32_t TableSin(int nAngle) { return tableSine.nValue[nAngle & (nAngleSteps - 1)]; }
+inline int32_t TableCos(int nAngle) { return tableSine.nValue[(nAngle + nAngleSteps / 4) & (nAngleSteps - 1)]; }
+
+// Binary angle of the vector (x, y); the components can be in any common scale
+inline int TableAtan2(int32_t y, int32_t x)
+{
+	if (x == 0 && y == 0)
+		return 0;
+
+	// Folds the vector into the first octant, where the tangent is between 0 and 1
+	int64_t ax = x < 0 ? -(int64_t)x : x;
+	int64_t ay = y < 0 ? -(int64_t)y : y;
+	bool bSteep = ay > ax;
+	int64_t nMin = bSteep ? ax : ay;
+	int64_t nMax = bSteep ? ay : ax;
+
+	// Finds the largest octant angle whose tangent does not exceed min / max
+	int nLow = 0, nHigh = nAngleSteps / 8;
+	while (nLow < nHigh)
 	{
-		vecTransformedCoordinates[i].first = vecTransformedCoordinates[i].first * s;
-		vecTransformedCoordinates[i].second = vecTransformedCoordinates[i].second * s;
+		int nMid = (nLow + nHigh + 1) / 2;
+		if (tableTangent.nValue[nMid] * nMax <= nMin * 65536)
+			nLow = nMid;
+		else
+			nHigh = nMid - 1;
 	}
 
-	// Translates
-	for (int i = 0; i < verts; i++)
+	// Unfolds the octant angle back to the full turn
+	int nAngle = bSteep ? nAngleSteps / 4 - nLow : nLow;
+	if (x < 0) nAngle = nAngleSteps / 2 - nAngle;
+	if (y < 0) nAngle = -nAngle;
+	return nAngle & (nAngleSteps - 1);
+}
+
+inline int AngleFromRadians(float fRadians)
+{
+	return (int)floorf(fRadians * ((float)nAngleSteps / 6.2831853f) + 0.5f) & (nAngleSteps - 1);
+}
+
+inline uint64_t IntegerSqrt(uint64_t v)
+{
+	uint64_t nResult = 0;
+	uint64_t nBit = (uint64_t)1 << 62;
+	while (nBit > v)
+		nBit >>= 2;
+	while (nBit != 0)
 	{
-		vecTransformedCoordinates[i].first = vecTransformedCoordinates[i].first + x;
-		vecTransformedCoordinates[i].second = vecTransformedCoordinates[i].second + y;
+		if (v >= nResult + nBit)
+		{
+			v -= nResult + nBit;
+			nResult = (nResult >> 1) + nBit;
+		}
+		else
+			nResult >>= 1;
+		nBit >>= 2;
 	}
+	return nResult;
+}
+
+class cFixed		// 16.16 fixed point number, converts to and from float so rendering code can stay in float
+{
+public:
+	int32_t n = 0;		// Raw value, in 1/65536ths
+
+	cFixed() = default;
+	cFixed(int i) : n(Saturate((int64_t)i * 65536)) {}
+	cFixed(float f) : n(Saturate((double)f * 65536.0)) {}
+	cFixed(double f) : n(Saturate(f * 65536.0)) {}
+
+	static cFixed FromRaw(int32_t n) { cFixed f; f.n = n; return f; }
+
+	// Values out of range stick at the largest or smallest number rather than wrapping round to the other sign
+	static int32_t Saturate(int64_t n) { return (int32_t)max<int64_t>(INT32_MIN, min<int64_t>(n, INT32_MAX)); }
+	static int32_t Saturate(double f) { return (int32_t)max(-2147483648.0, min(f, 2147483647.0)); }
+
+	operator float() const { return (float)n / 65536.0f; }
+
+	cFixed operator - () const { return FromRaw(-n); }
+	cFixed& operator += (cFixed b) { n += b.n; return *this; }
+	cFixed& operator -= (cFixed b) { n -= b.n; return *this; }
+	cFixed& operator *= (cFixed b) { n = Saturate(((int64_t)n * b.n) >> 16); return *this; }
+	cFixed& operator /= (cFixed b) { n = b.n != 0 ? Saturate(((int64_t)n * 65536) / b.n) : n >= 0 ? INT32_MAX : INT32_MIN; return *this; }		// Dividing by zero gives the largest number of the right sign
+};
+
+inline cFixed operator + (cFixed a, cFixed b) { return a += b; }
+inline cFixed operator - (cFixed a, cFixed b) { return a -= b; }
+inline cFixed operator * (cFixed a, cFixed b) { return a *= b; }
+inline cFixed operator / (cFixed a, cFixed b) { return a /= b; }
+inline bool operator == (cFixed a, cFixed b) { return a.n == b.n; }
+inline bool operator != (cFixed a, cFixed b) { return a.n != b.n; }
+inline bool operator < (cFixed a, cFixed b) { return a.n < b.n; }
+inline bool operator > (cFixed a, cFixed b) { return a.n > b.n; }
+inline bool operator <= (cFixed a, cFixed b) { return a.n <= b.n; }
+inline bool operator >= (cFixed a, cFixed b) { return a.n >= b.n; }
+
+// Mixing a fixed point number with a plain number does the arithmetic in fixed point, rather than
+// letting the compiler pick between float and fixed point
+#define FIXED_MIXED_OPERATOR(op, result) \
+	template <class T, class = typename enable_if<is_arithmetic<T>::value>::type> \
+	inline result operator op (cFixed a, T b) { return a op cFixed(b); } \
+	template <class T, class = typename enable_if<is_arithmetic<T>::value>::type> \
+	inline result operator op (T a, cFixed b) { return cFixed(a) op b; }
+FIXED_MIXED_OPERATOR(+, cFixed)
+FIXED_MIXED_OPERATOR(-, cFixed)
+FIXED_MIXED_OPERATOR(*, cFixed)
+FIXED_MIXED_OPERATOR(/, cFixed)
+FIXED_MIXED_OPERATOR(==, bool)
+FIXED_MIXED_OPERATOR(!=, bool)
+FIXED_MIXED_OPERATOR(<, bool)
+FIXED_MIXED_OPERATOR(>, bool)
+FIXED_MIXED_OPERATOR(<=, bool)
+FIXED_MIXED_OPERATOR(>=, bool)
+#undef FIXED_MIXED_OPERATOR
+
+inline cFixed RealLength(cFixed x, cFixed y)
+{
+	return cFixed::FromRaw((int32_t)IntegerSqrt((uint64_t)((int64_t)x.n * x.n + (int64_t)y.n * y.n)));
+}
+inline int ToInt(cFixed f) { return f.n >> 16; }
+inline int CeilToInt(cFixed f) { return (f.n + 0xFFFF) >> 16; }
+inline int VectorAngle(cFixed x, cFixed y) { return TableAtan2(y.n, x.n); }
+
+inline float RealLength(float x, float y) { return sqrtf(x * x + y * y); }
+inline int ToInt(float f) { return (int)f; }
+inline int CeilToInt(float f) { return (int)ceilf(f); }
+inline int VectorAngle(float x, float y) { return TableAtan2((int32_t)(y * 1024.0f), (int32_t)(x * 1024.0f)); }		// Binary angle, without atan2f
+
+#if defined(WORMS_FIXED_POINT)
+typedef cFixed real_t;
+inline cFixed RealCos(float fRadians) { return cFixed::FromRaw(TableCos(AngleFromRadians(fRadians))); }
+inline cFixed RealSin(float fRadians) { return cFixed::FromRaw(TableSin(AngleFromRadians(fRadians))); }
+#else
+typedef float real_t;
+inline float RealCos(float fRadians) { return cosf(fRadians); }
+inline float RealSin(float fRadians) { return sinf(fRadians); }
+#endif
+
+const int nModelAngles = 64;		// Wire frame models are pre-rotated to this many directions, more than their few pixels can show
+
+struct sModelPoint
+{
+	float x;
+	float y;
+};
 
-	// Draws closed polygon
-	for (int i = 0; i < verts + 1; i++)
+template <int nVerts>
+struct sRotatedModel		// A wire frame model at each of the model angles; vPoints[a] is the model turned a / nModelAngles of a turn
+{
+	sModelPoint vPoints[nModelAngles][nVerts];
+};
+
+// Rotates a unit model to every model angle, using the sine table so it can run at compile time
+template <int nVerts>
+constexpr sRotatedModel<nVerts> RotateModel(const sModelPoint (&vModel)[nVerts])
+{
+	sRotatedModel<nVerts> model = {};
+	for (int a = 0; a < nModelAngles; a++)
 	{
-		int j = (i + 1);
-		engine->DrawLine(vecTransformedCoordinates[i % verts].first, vecTransformedCoordinates[i % verts].second,
-			vecTransformedCoordinates[j % verts].first, vecTransformedCoordinates[j % verts].second, col);
+		int nAngle = a * (nAngleSteps / nModelAngles);
+		float c = (float)tableSine.nValue[(nAngle + nAngleSteps / 4) & (nAngleSteps - 1)] / 65536.0f;
+		float s = (float)tableSine.nValue[nAngle] / 65536.0f;
+		for (int i = 0; i < nVerts; i++)
+		{
+			model.vPoints[a][i].x = vModel[i].x * c - vModel[i].y * s;
+			model.vPoints[a][i].y = vModel[i].x * s + vModel[i].y * c;
+		}
 	}
+	return model;
+}
+
+// Which of a model's pre-rotated copies faces along the vector (x, y)
+inline int ModelAngle(real_t x, real_t y)
+{
+	const int nStep = nAngleSteps / nModelAngles;
+	return ((VectorAngle(x, y) + nStep / 2) / nStep) & (nModelAngles - 1);
 }
 
+// A horizontal strip of rows of a draw target. It's drawn into without touching any engine state, so each
+// band of the screen can be drawn by a different thread at once
+struct sBand
+{
+	olc::Sprite* pTarget;
+	int nRowStart;		// First row of the band
+	int nRowEnd;		// One past the last row of the band
+
+	void Draw(int32_t x, int32_t y, olc::Pixel col) const		// Same as PixelGameEngine::Draw in NORMAL mode, clipped to the band
+	{
+		if (x >= 0 && x < pTarget->width && y >= nRowStart && y < nRowEnd)
+			pTarget->GetData()[y * pTarget->width + x] = col;
+	}
+};
+
+// A sprite sheet of equally sized cells, compiled into runs of opaque pixels per row. Drawing a cell is the same as
+// DrawPartialSprite in MASK mode, but clipping is worked out once per row and each run is copied in one go
+class cCompiledSprite
+{
+public:
+	cCompiledSprite(const olc::Sprite* pSprite, int nCellW, int nCellH)
+	{
+		nCellWidth = nCellW;
+		nCellHeight = nCellH;
+		nCellsX = pSprite->width / nCellW;
+		int nCells = nCellsX * (pSprite->height / nCellH);
+
+		for (int c = 0; c < nCells; c++)
+			for (int r = 0; r < nCellHeight; r++)
+			{
+				vecRowFirstSpan.push_back((int)vecSpans.size());
+				const olc::Pixel* pRow = &pSprite->pColData[((c / nCellsX) * nCellHeight + r) * pSprite->width + (c % nCellsX) * nCellWidth];
+				for (int x = 0; x < nCellWidth; x++)
+				{
+					if (pRow[x].a != 255)
+						continue;
+
+					sSpan span = { x, 0, (int)vecPixels.size() };
+					while (x < nCellWidth && pRow[x].a == 255)
+						vecPixels.push_back(pRow[x++]);
+					span.nLength = x - span.x;
+
+					// Also stores the run back to front, for drawing the cell mirrored
+					for (int i = span.nLength - 1; i >= 0; i--)
+						vecPixelsMirrored.push_back(vecPixels[span.nPixel + i]);
+					vecSpans.push_back(span);
+				}
+			}
+		vecRowFirstSpan.push_back((int)vecSpans.size());
+	}
+
+	// Draws cell (cx, cy) with its top left at (x, y), scaled up by a whole number and flipped like olc::Sprite::Flip
+	void DrawCell(const sBand& band, int32_t x, int32_t y, int cx, int cy, int nScale = 1, uint8_t nFlip = olc::Sprite::NONE) const
+	{
+		int nCell = cy * nCellsX + cx;
+		bool bMirror = (nFlip & olc::Sprite::HORIZ) != 0;
+		const olc::Pixel* pPixels = bMirror ? vecPixelsMirrored.data() : vecPixels.data();
+		int nWidth = band.pTarget->width;
+
+		// Only rows of the cell that land in the band are visited
+		int nFirstRow = max(0, (band.nRowStart - y) / nScale);
+		int nLastRow = min(nCellHeight, (band.nRowEnd - y + nScale - 1) / nScale);
+		for (int r = nFirstRow; r < nLastRow; r++)
+		{
+			int nSourceRow = (nFlip & olc::Sprite::VERT) ? nCellHeight - 1 - r : r;
+			int nRow = nCell * nCellHeight + nSourceRow;
+			for (int s = vecRowFirstSpan[nRow]; s < vecRowFirstSpan[nRow + 1]; s++)
+			{
+				const sSpan& span = vecSpans[s];
+				int nStart = x + (bMirror ? nCellWidth - span.x - span.nLength : span.x) * nScale;
+				int nSkip = max(0, -nStart);		// Whole target pixels cut off by the left edge
+				int nEnd = min(nWidth, nStart + span.nLength * nScale);
+				if (nStart + nSkip >= nEnd)
+					continue;
+
+				for (int dy = 0; dy < nScale; dy++)
+				{
+					int nY = y + r * nScale + dy;
+					if (nY < band.nRowStart || nY >= band.nRowEnd)
+						continue;
+
+					olc::Pixel* pDest = band.pTarget->GetData() + nY * nWidth;
+					const olc::Pixel* pSource = pPixels + span.nPixel;
+					if (nScale == 1)
+						memcpy(pDest + nStart + nSkip, pSource + nSkip, (nEnd - nStart - nSkip) * sizeof(olc::Pixel));
+					else
+						for (int i = nStart + nSkip; i < nEnd; i++)
+							pDest[i] = pSource[(i - nStart) / nScale];
+				}
+			}
+		}
+	}
+
+	int GetCellWidth() const { return nCellWidth; }
+	int GetCellHeight() const { return nCellHeight; }
+
+private:
+	struct sSpan		// A run of opaque pixels in one row of a cell
+	{
+		int x;			// Where the run starts in the row
+		int nLength;
+		int nPixel;		// Index of the run's first pixel in vecPixels
+	};
+
+	int nCellWidth = 0;
+	int nCellHeight = 0;
+	int nCellsX = 0;
+	vector<int> vecRowFirstSpan;		// First span of every row of every cell, plus one past the last span at the end
+	vector<sSpan> vecSpans;
+	vector<olc::Pixel> vecPixels;
+	vector<olc::Pixel> vecPixelsMirrored;		// Each run's pixels in reverse, at the same index as in vecPixels
+};
+
+// Text in the engine's font, drawn without going through Draw for every pixel. The font is compiled once per colour
+// and scale, so a glyph is a few runs of opaque pixels; a string drawn again while it's still remembered is compiled
+// whole, so unchanged labels cost one copy per run. Colours are drawn opaque
+class cTextCache
+{
+public:
+	void SetFont(const olc::Sprite* pFont)
+	{
+		pFontSprite = pFont;
+		mapFonts.clear();
+		mapStrings.clear();
+	}
+
+	// Draws text with its top left at (x, y) like PixelGameEngine::DrawString in NORMAL mode, clipped to the band
+	void Draw(const sBand& band, int32_t x, int32_t y, const string& sText, olc::Pixel col, int nScale = 1)
+	{
+		sString& str = mapStrings[make_tuple(sText, col.n | 0xFF000000, nScale)];
+		str.nLastUsed = nFrame;
+		if (str.spr == nullptr && ++str.nUses >= 2)		// Seen before, so it's likely to stay; worth compiling whole
+		{
+			olc::vi2d vSize = GetTextSize(sText) * nScale;
+			if (vSize.x <= 0 || vSize.y <= 0)
+				return;
+			olc::Sprite sprText(vSize.x, vSize.y);
+			fill(sprText.pColData.begin(), sprText.pColData.end(), olc::BLANK);
+			DrawGlyphs({ &sprText, 0, vSize.y }, 0, 0, sText, col, nScale);
+			str.spr.reset(new cCompiledSprite(&sprText, vSize.x, vSize.y));
+		}
+
+		if (str.spr != nullptr)
+			str.spr->DrawCell(band, x, y, 0, 0);
+		else
+			DrawGlyphs(band, x, y, sText, col, nScale);
+	}
+
+	void EndFrame()		// Forgets strings that haven't been drawn for a second or so
+	{
+		nFrame++;
+		for (auto it = mapStrings.begin(); it != mapStrings.end();)
+			it = nFrame - it->second.nLastUsed > 60 ? mapStrings.erase(it) : next(it);
+	}
+
+	static olc::vi2d GetTextSize(const string& sText)		// Same as PixelGameEngine::GetTextSize, at scale 1
+	{
+		olc::vi2d vSize = { 0, 1 }, vPos = { 0, 1 };
+		for (char c : sText)
+		{
+			if (c == '\n') { vPos.y++; vPos.x = 0; }
+			else if (c == '\t') vPos.x += olc::nTabSizeInSpaces;
+			else vPos.x++;
+			vSize.x = max(vSize.x, vPos.x);
+			vSize.y = max(vSize.y, vPos.y);
+		}
+		return vSize * 8;
+	}
+
+private:
+	void DrawGlyphs(const sBand& band, int32_t x, int32_t y, const string& sText, olc::Pixel col, int nScale)
+	{
+		const cCompiledSprite& font = GetFont(col, nScale);
+		int32_t sx = 0, sy = 0;
+		for (char c : sText)
+		{
+			if (c == '\n')
+			{
+				sx = 0;
+				sy += 8 * nScale;
+			}
+			else if (c == '\t')
+				sx += 8 * olc::nTabSizeInSpaces * nScale;
+			else
+			{
+				if (c >= 32 && (unsigned char)c < 128)		// The font sheet only has the printable characters
+					font.DrawCell(band, x + sx, y + sy, (c - 32) % 16, (c - 32) / 16);
+				sx += 8 * nScale;
+			}
+		}
+	}
+
+	const cCompiledSprite& GetFont(olc::Pixel col, int nScale)		// The font sheet in one colour, scaled up, compiled on first use
+	{
+		unique_ptr<cCompiledSprite>& font = mapFonts[make_pair(col.n | 0xFF000000, nScale)];
+		if (font == nullptr)
+		{
+			col.a = 255;
+			olc::Sprite sprFont(pFontSprite->width * nScale, pFontSprite->height * nScale);
+			for (int y = 0; y < sprFont.height; y++)
+				for (int x = 0; x < sprFont.width; x++)		// Lit font pixels are the ones with any red in them, as in DrawString
+					sprFont.pColData[y * sprFont.width + x] = pFontSprite->pColData[(y / nScale) * pFontSprite->width + x / nScale].r > 0 ? col : olc::BLANK;
+			font.reset(new cCompiledSprite(&sprFont, 8 * nScale, 8 * nScale));
+		}
+		return *font;
+	}
+
+	struct sString
+	{
+		unique_ptr<cCompiledSprite> spr;		// The whole string, once it's been drawn more than once
+		int nUses = 0;
+		int nLastUsed = 0;		// Frame it was last drawn in
+	};
+
+	const olc::Sprite* pFontSprite = nullptr;
+	map<pair<uint32_t, int>, unique_ptr<cCompiledSprite>> mapFonts;		// By colour and scale
+	map<tuple<string, uint32_t, int>, sString> mapStrings;		// By text, colour and scale
+	int nFrame = 0;
+};
+
+// Port DrawWireFrameModel function from Console Game Engine, batched: every wire frame object of a frame is
+// transformed into one reusable line list, which is then sorted into bands of rows and rasterized band by band
+class cWireFrameBatch
+{
+public:
+	void Begin(int nWidth, int nHeight)		// Starts a frame's batch for a draw target of the given size
+	{
+		nTargetWidth = nWidth;
+		nTargetHeight = nHeight;
+		vecLines.clear();		// Keeps its capacity, so after the first few frames adding lines never allocates
+	}
+
+	// Adds the edges of one already rotated model as a closed polygon
+	template <int nVerts>
+	void Add(const sModelPoint (&vModel)[nVerts], float x, float y, float s = 1.0f, olc::Pixel col = olc::WHITE)
+	{
+		// vModel : the rotated wire frame model
+		// x, y : the screenposition where to draw it
+		// s : scaling factor
+
+		// Scales, translates and finds the screen bounds in one pass, into a buffer on the stack
+		int32_t nX[nVerts];
+		int32_t nY[nVerts];
+		int32_t nMinX = INT32_MAX, nMinY = INT32_MAX, nMaxX = INT32_MIN, nMaxY = INT32_MIN;
+		for (int i = 0; i < nVerts; i++)
+		{
+			nX[i] = (int32_t)(vModel[i].x * s + x);
+			nY[i] = (int32_t)(vModel[i].y * s + y);
+			nMinX = min(nMinX, nX[i]); nMaxX = max(nMaxX, nX[i]);
+			nMinY = min(nMinY, nY[i]); nMaxY = max(nMaxY, nY[i]);
+		}
+
+		// Culls the whole model against the target once, instead of every pixel of every edge
+		if (nMaxX < 0 || nMaxY < 0 || nMinX >= nTargetWidth || nMinY >= nTargetHeight)
+			return;
+		bool bClip = nMinX < 0 || nMinY < 0 || nMaxX >= nTargetWidth || nMaxY >= nTargetHeight;
+
+		for (int i = 0; i < nVerts; i++)
+		{
+			int j = (i + 1) % nVerts;
+			vecLines.push_back({ nX[i], nY[i], nX[j], nY[j], col, bClip });
+		}
+	}
+
+	void Bin(int nBandHeight, int nBands)		// Sorts the lines into the bands of rows they touch, ready for FlushBand
+	{
+		vecBandLines.resize(nBands);
+		for (auto& v : vecBandLines)
+			v.clear();
+
+		for (int i = 0; i < (int)vecLines.size(); i++)
+		{
+			const sLine& l = vecLines[i];
+			int nFirst = max(min(l.y1, l.y2), 0) / nBandHeight;
+			int nLast = min(max(l.y1, l.y2) / nBandHeight, nBands - 1);
+			for (int b = nFirst; b <= nLast; b++)
+				vecBandLines[b].push_back(i);
+		}
+	}
+
+	// Rasterizes the lines binned into one band, touching only that band's rows; bands can be flushed in parallel
+	void FlushBand(olc::PixelGameEngine* engine, int nBand, const sBand& band)
+	{
+		olc::Pixel* pData = band.pTarget->GetData();
+		for (int i : vecBandLines[nBand])
+		{
+			const sLine& l = vecLines[i];
+			if (!l.bClip && min(l.y1, l.y2) >= band.nRowStart && max(l.y1, l.y2) < band.nRowEnd)
+				DrawLineUnclipped(pData, l);
+			else
+				DrawLineInBand(engine, band, l);
+		}
+	}
+
+	size_t GetLineCount() const { return vecLines.size(); }
+
+private:
+	struct sLine
+	{
+		int32_t x1, y1, x2, y2;
+		olc::Pixel col;
+		bool bClip;		// Some of the line may be outside the target
+	};
+
+	// The same Bresenham walk as PixelGameEngine::DrawLine, so lines look identical, but writing straight into the target
+	void DrawLineUnclipped(olc::Pixel* pData, const sLine& l)
+	{
+		int dx = l.x2 - l.x1, dy = l.y2 - l.y1;
+		int dx1 = abs(dx), dy1 = abs(dy);
+		bool bSameSign = (dx < 0 && dy < 0) || (dx > 0 && dy > 0);
+
+		if (dy1 <= dx1)		// Mostly horizontal, walks from the left end
+		{
+			bool bForward = dx >= 0;
+			int nIndex = bForward ? l.y1 * nTargetWidth + l.x1 : l.y2 * nTargetWidth + l.x2;
+			int nSteps = dx1;
+			int nStepY = bSameSign ? nTargetWidth : -nTargetWidth;
+			int e = 2 * dy1 - dx1;
+			pData[nIndex] = l.col;
+			for (int i = 0; i < nSteps; i++)
+			{
+				nIndex++;
+				if (e < 0)
+					e += 2 * dy1;
+				else
+				{
+					nIndex += nStepY;
+					e += 2 * (dy1 - dx1);
+				}
+				pData[nIndex] = l.col;
+			}
+		}
+		else		// Mostly vertical, walks from the top end
+		{
+			bool bForward = dy >= 0;
+			int nIndex = bForward ? l.y1 * nTargetWidth + l.x1 : l.y2 * nTargetWidth + l.x2;
+			int nSteps = dy1;
+			int nStepX = bSameSign ? 1 : -1;
+			int e = 2 * dx1 - dy1;
+			pData[nIndex] = l.col;
+			for (int i = 0; i < nSteps; i++)
+			{
+				nIndex += nTargetWidth;
+				if (e <= 0)
+					e += 2 * dx1;
+				else
+				{
+					nIndex += nStepX;
+					e += 2 * (dx1 - dy1);
+				}
+				pData[nIndex] = l.col;
+			}
+		}
+	}
+
+	// PixelGameEngine::DrawLine step for step, including its clipping to the screen, but only plotting the band's rows
+	void DrawLineInBand(olc::PixelGameEngine* engine, const sBand& band, const sLine& l)
+	{
+		int dx = l.x2 - l.x1, dy = l.y2 - l.y1;
+		olc::vi2d p1(l.x1, l.y1), p2(l.x2, l.y2);
+		if (!engine->ClipLineToScreen(p1, p2))
+			return;
+
+		int x, y, xe, ye;
+		int dx1 = abs(dx), dy1 = abs(dy);
+		int px = 2 * dy1 - dx1, py = 2 * dx1 - dy1;
+		bool bSameSign = (dx < 0 && dy < 0) || (dx > 0 && dy > 0);
+
+		if (dx == 0)		// Vertical
+		{
+			for (y = min(p1.y, p2.y); y <= max(p1.y, p2.y); y++)
+				band.Draw(p1.x, y, l.col);
+		}
+		else if (dy == 0)		// Horizontal
+		{
+			for (x = min(p1.x, p2.x); x <= max(p1.x, p2.x); x++)
+				band.Draw(x, p1.y, l.col);
+		}
+		else if (dy1 <= dx1)
+		{
+			if (dx >= 0) { x = p1.x; y = p1.y; xe = p2.x; }
+			else { x = p2.x; y = p2.y; xe = p1.x; }
+			band.Draw(x, y, l.col);
+			while (x < xe)
+			{
+				x++;
+				if (px < 0)
+					px += 2 * dy1;
+				else
+				{
+					y += bSameSign ? 1 : -1;
+					px += 2 * (dy1 - dx1);
+				}
+				band.Draw(x, y, l.col);
+			}
+		}
+		else
+		{
+			if (dy >= 0) { x = p1.x; y = p1.y; ye = p2.y; }
+			else { x = p2.x; y = p2.y; ye = p1.y; }
+			band.Draw(x, y, l.col);
+			while (y < ye)
+			{
+				y++;
+				if (py <= 0)
+					py += 2 * dx1;
+				else
+				{
+					x += bSameSign ? 1 : -1;
+					py += 2 * (dx1 - dy1);
+				}
+				band.Draw(x, y, l.col);
+			}
+		}
+	}
+
+	int nTargetWidth = 0;
+	int nTargetHeight = 0;
+	vector<sLine> vecLines;
+	vector<vector<int>> vecBandLines;		// Indices into vecLines of the lines that touch each band
+};
+
+// An engine layer that is only redrawn when what it shows changes. Every frame the caller lists the values the
+// layer is drawn from; if they match last frame's, the layer is left alone and the engine uploads nothing for it.
+// Otherwise the regions drawn last time are cleared and the layer is drawn again, so the only pixels uploaded
+// are the ones that were covered before or are covered now
+class cLayerCache
+{
+public:
+	void Create(olc::PixelGameEngine* engine, uint8_t nLayerIndex)		// Starts the layer off see-through
+	{
+		pEngine = engine;
+		nLayer = nLayerIndex;
+		bDrawn = false;
+		vecDrawn.clear();
+		pEngine->EnableLayer(nLayer, true);
+		pEngine->SetDrawTarget(nLayer);
+		pEngine->Clear(olc::BLANK);
+		pEngine->SetDrawTarget(nullptr);
+	}
+
+	// Values the layer is drawn from this frame
+	void Add(int n) { vecKey.push_back((uint32_t)n); }
+	void Add(float f) { uint32_t n; memcpy(&n, &f, sizeof(n)); vecKey.push_back(n); }
+
+	// Whether the layer has to be drawn again. If so, it's cleared and made the draw target until End
+	bool Begin(bool bForce = false)
+	{
+		bool bChanged = bForce || !bDrawn || vecKey != vecLastKey;
+		swap(vecKey, vecLastKey);
+		vecKey.clear();
+
+		// Told to update a layer with nothing marked, the engine uploads all of it. Only what's cleared and
+		// drawn here is marked, so that's turned off even when the layer is left as it is
+		pEngine->SetDrawTarget(nLayer, false);
+		if (!bChanged)
+		{
+			pEngine->SetDrawTarget(nullptr);
+			return false;
+		}
+
+		for (const olc::DirtyRect& r : vecDrawn)
+			pEngine->FillRect(r.vMin, r.vMax - r.vMin, olc::BLANK);
+
+		// Sets the cleared regions aside, so afterwards the layer's dirty regions are just what gets drawn now
+		vector<olc::DirtyRect>& vecDirty = pEngine->GetLayers()[nLayer].vecDirty;
+		vecCleared = vecDirty;
+		vecDirty.clear();
+		return true;
+	}
+
+	void End()
+	{
+		vecDrawn = pEngine->GetLayers()[nLayer].vecDirty;
+		for (const olc::DirtyRect& r : vecCleared)		// Still need uploading, now as blank
+			pEngine->MarkDirty(r.vMin, r.vMax - r.vMin);
+		pEngine->SetDrawTarget(nullptr);
+		bDrawn = true;
+	}
+
+private:
+	olc::PixelGameEngine* pEngine = nullptr;
+	uint8_t nLayer = 0;
+	bool bDrawn = false;		// Nothing has been drawn yet, so the first Begin always draws
+	vector<uint32_t> vecKey;
+	vector<uint32_t> vecLastKey;
+	vector<olc::DirtyRect> vecDrawn;		// Regions the last drawing covered, cleared before the next
+	vector<olc::DirtyRect> vecCleared;
+};
+
 // Physics engine
 class cPhysicsObject
 {
 public:
 	// Position
-	float px = 0.0f;
-	float py = 0.0f;
+	real_t px = 0.0f;
+	real_t py = 0.0f;
 	// Velocity
-	float vx = 0.0f;
-	float vy = 0.0f;
+	real_t vx = 0.0f;
+	real_t vy = 0.0f;
 	// Acceleration
-	float ax = 0.0f;
-	float ay = 0.0f;
+	real_t ax = 0.0f;
+	real_t ay = 0.0f;
 
-	float radius = 4.0f;		// Represents collision boundary of an object
+	real_t radius = 4.0f;		// Represents collision boundary of an object
 	bool bStable = false;		// Represents whether object is stable/stopped moving
-	float fFriction = 0.8f;		// Represents the dampening factor for an object's collision
+	real_t fFriction = 0.8f;		// Represents the dampening factor for an object's collision
 
 	int nBounceBeforeDeath = -1;		// Represents number of times an object can bounce before 'dying'; -1 means infinite bounces
 	bool bDead = false;			// Represents indicator to check if object should be removed
+	int nSubsteps = 10;		// How many of a frame's physics iterations move this object; 0 means it's asleep
+	bool bTouchingTerrain = false;		// Collided with the terrain on its last step
+
+	enum OBJECT_TYPE		// Which concrete class an object is, so its slot can be handed back to the right pool
+	{
+		OBJ_DUMMY = 0,
+		OBJ_DEBRIS,
+		OBJ_MISSILE,
+		OBJ_WORM
+	} nType = OBJ_DUMMY;
 
 	// Default constructor that sets position
-	cPhysicsObject(float x = 0.0f, float y = 0.0f)
+	cPhysicsObject(real_t x = 0.0f, real_t y = 0.0f)
 	{
 		px = x;
 		py = y;
 	}
 
-	// Makes the class abstract
-	virtual void Draw(olc::PixelGameEngine* engine, float fOffsetX, float fOffsetY, bool bPixel = false) = 0;
-	virtual int BounceDeathAction() = 0;
-	virtual bool Damage(float d) = 0;
+	// The object types are a closed set, so this switches on nType instead of going through a virtual table.
+	// Physics and drawing aren't dispatched at all: they walk each type's objects in their own loop
+	bool Damage(float d);
 };
 
 class cDummy : public cPhysicsObject		// Does nothing, shows a marker that helps with physics debug and test
@@ -93,47 +796,46 @@ public:
 
 	}
 
-	virtual void Draw(olc::PixelGameEngine* engine, float fOffsetX, float fOffsetY)
+	void Draw(cWireFrameBatch& batch, float fOffsetX, float fOffsetY)
 	{
-		DrawWireFrameModel(engine, vecModel, px - fOffsetX, py - fOffsetY, atan2f(vy, vx), radius, olc::WHITE);
-		// vecModel : Drawn model data
+		batch.Add(model.vPoints[ModelAngle(vx, vy)], px - fOffsetX, py - fOffsetY, radius, olc::WHITE);
+		// model.vPoints[] : Drawn model data, already rotated to face along the velocity
 		// p - fOffset :  (x,y) Coordinates
-		// atan2f() : Angle object is rotated
 		// radius : Scales object's size
 		// olc::WHITE : Makes characters white
 	}
 
-	virtual int BounceDeathAction()
+	int BounceDeathAction()
 	{
 		return 0;		// Does nothing, just fades away
 	}
 
 private:
-	static vector<pair<float, float>> vecModel;		// Allows one model to be shared across all objects of the same class
+	static const sRotatedModel<11> model;		// Allows one model to be shared across all objects of the same class
 };
 
 /* Dummys for debugging purposes
-vector<pair<float, float>> DefineDummy()		// Creates a unit circle with a line fom center to edge
+constexpr sRotatedModel<11> DefineDummy()		// Creates a unit circle with a line fom center to edge
 {
-	vector<pair<float, float>> vecModel;
-	vecModel.push_back({ 0.0f, 0.0f });
-
+	sModelPoint vModel[11] = {};
 	for (int i = 0; i < 10; i++)
-		vecModel.push_back({ cosf(i / 9.0f * 2.0f * 3.14159f), sinf(i / 9.0f * 2.0f * 3.14159f) });
+		vModel[i + 1] = { tableSine.nValue[(i * nAngleSteps / 9 + nAngleSteps / 4) & (nAngleSteps - 1)] / 65536.0f,
+			tableSine.nValue[(i * nAngleSteps / 9) & (nAngleSteps - 1)] / 65536.0f };
 
-	return vecModel;
+	return RotateModel(vModel);
 }
-vector<pair<float, float>> cDummy::vecModel = DefineDummy();
+const sRotatedModel<11> cDummy::model = DefineDummy();
 */
 
 class cDebris : public cPhysicsObject // A small rock that bounces
 {
 public:
-	cDebris(float x = 0.0f, float y = 0.0f) : cPhysicsObject(x, y)
+	cDebris(real_t x = 0.0f, real_t y = 0.0f, real_t _vx = 0.0f, real_t _vy = 0.0f) : cPhysicsObject(x, y)
 	{
-		// Sets velocity to random direction and size to make a "boom" effect
-		vx = 10.0f * cosf(((float)rand() / (float)RAND_MAX) * 2.0f * 3.14159f);
-		vy = 10.0f * sinf(((float)rand() / (float)RAND_MAX) * 2.0f * 3.14159f);
+		// Velocity is chosen by whoever makes the "boom" effect, so it comes from that match's random numbers
+		vx = _vx;
+		vy = _vy;
+		nType = OBJ_DEBRIS;
 		radius = 1.0f;
 		fFriction = 0.8f;
 		bDead = false;
@@ -141,42 +843,46 @@ public:
 		nBounceBeforeDeath = 2;		// Deletes after bouncing 2 times		
 	}
 
-	virtual void Draw(olc::PixelGameEngine* engine, float fOffsetX, float fOffsetY, bool bPixel = false)
+	void Draw(cWireFrameBatch& batch, float fOffsetX, float fOffsetY, bool bPixel = false, bool bLowDetail = false)
 	{
-		DrawWireFrameModel(engine, vecModel, px - fOffsetX, py - fOffsetY, atan2f(vy, vx), bPixel ? 0.5f : radius, olc::DARK_GREEN);
+		// A rock this small looks the same whichever way it faces, so low detail drawing doesn't rotate it
+		batch.Add(model.vPoints[bLowDetail ? 0 : ModelAngle(vx, vy)], px - fOffsetX, py - fOffsetY, bPixel ? 0.5f : (float)radius, olc::DARK_GREEN);
 	}
 
-	virtual int BounceDeathAction()
+	int BounceDeathAction()
 	{
 		return 0;		// Does nothing, just fades away
 	}
 
-	virtual bool Damage(float d)
+	bool Damage(float d)
 	{
 		return true;		// Can't be damaged
 	}
 
 private:
-	static vector<pair<float, float>> vecModel;
+	static const sRotatedModel<4> model;
 };
 
-vector<pair<float, float>> DefineDebris()
+constexpr sRotatedModel<4> DefineDebris()
 {
 	// A small unit rectangle
-	vector<pair<float, float>> vecModel;
-	vecModel.push_back({ 0.0f, 0.0f });
-	vecModel.push_back({ 1.0f, 0.0f });
-	vecModel.push_back({ 1.0f, 1.0f });
-	vecModel.push_back({ 0.0f, 1.0f });
-	return vecModel;
+	const sModelPoint vModel[] =
+	{
+		{ 0.0f, 0.0f },
+		{ 1.0f, 0.0f },
+		{ 1.0f, 1.0f },
+		{ 0.0f, 1.0f }
+	};
+	return RotateModel(vModel);
 }
-vector<pair<float, float>> cDebris::vecModel = DefineDebris();
+const sRotatedModel<4> cDebris::model = DefineDebris();		// Evaluated by the compiler, so there's nothing to build at startup
 
 class cMissile : public cPhysicsObject		// A projectile weapon
 {
 public:
-	cMissile(float x = 0.0f, float y = 0.0f, float _vx = 0.0f, float _vy = 0.0f) : cPhysicsObject(x, y)
+	cMissile(real_t x = 0.0f, real_t y = 0.0f, real_t _vx = 0.0f, real_t _vy = 0.0f) : cPhysicsObject(x, y)
 	{
+		nType = OBJ_MISSILE;
 		radius = 2.5f;
 		fFriction = 0.5f;
 		vx = _vx;
@@ -186,94 +892,95 @@ public:
 		bStable = false;
 	}
 
-	virtual void Draw(olc::PixelGameEngine* engine, float fOffsetX, float fOffsetY, bool bPixel = false)
+	void Draw(cWireFrameBatch& batch, float fOffsetX, float fOffsetY, bool bPixel = false, bool bLowDetail = false)
 	{
-		DrawWireFrameModel(engine, vecModel, px - fOffsetX, py - fOffsetY, atan2f(vy, vx), bPixel ? 0.5f : radius, olc::BLACK);
+		batch.Add(model.vPoints[ModelAngle(vx, vy)], px - fOffsetX, py - fOffsetY, bPixel ? 0.5f : (float)radius, olc::BLACK);
 	}
 
-	virtual int BounceDeathAction()
+	int BounceDeathAction()
 	{
 		return 20;		// Gives the Boom Function a radius of 20 to make big explosions
 	}
 
-	virtual bool Damage(float d)
+	bool Damage(float d)
 	{
 		return true;
 	}
 
 private:
-	static vector<pair<float, float>> vecModel;
+	static const sRotatedModel<12> model;
 };
 
-vector<pair<float, float>> DefineMissile()
+constexpr sRotatedModel<12> DefineMissile()
 {
 	// Defines a rocket-like shape
-	vector<pair<float, float>> vecModel;
-	vecModel.push_back({ 0.0f, 0.0f });
-	vecModel.push_back({ 1.0f, 1.0f });
-	vecModel.push_back({ 2.0f, 1.0f });
-	vecModel.push_back({ 2.5f, 0.0f });
-	vecModel.push_back({ 2.0f, -1.0f });
-	vecModel.push_back({ 1.0f, -1.0f });
-	vecModel.push_back({ 0.0f, 0.0f });
-	vecModel.push_back({ -1.0f, -1.0f });
-	vecModel.push_back({ -2.5f, -1.0f });
-	vecModel.push_back({ -2.0f, 0.0f });
-	vecModel.push_back({ -2.5f, 1.0f });
-	vecModel.push_back({ -1.0f, 1.0f });
-	
-	for (auto& v : vecModel)		// Scales points to make the shape unit sized
-	{
-		v.first /= 1.5f;
-		v.second /= 1.5f;
-	}
-	return vecModel;
+	sModelPoint vModel[] =
+	{
+		{ 0.0f, 0.0f },
+		{ 1.0f, 1.0f },
+		{ 2.0f, 1.0f },
+		{ 2.5f, 0.0f },
+		{ 2.0f, -1.0f },
+		{ 1.0f, -1.0f },
+		{ 0.0f, 0.0f },
+		{ -1.0f, -1.0f },
+		{ -2.5f, -1.0f },
+		{ -2.0f, 0.0f },
+		{ -2.5f, 1.0f },
+		{ -1.0f, 1.0f }
+	};
+
+	for (auto& v : vModel)		// Scales points to make the shape unit sized
+	{
+		v.x /= 1.5f;
+		v.y /= 1.5f;
+	}
+	return RotateModel(vModel);
 }
-vector<pair<float, float>> cMissile::vecModel = DefineMissile();
+const sRotatedModel<12> cMissile::model = DefineMissile();
 
 class cWorm : public cPhysicsObject		// A unit, aka a Worm
 {
 public:
-	cWorm(float x = 0.0f, float y = 0.0f) : cPhysicsObject(x, y)
+	cWorm(real_t x = 0.0f, real_t y = 0.0f) : cPhysicsObject(x, y)
 	{
+		nType = OBJ_WORM;
 		radius = 3.5f;
 		fFriction = 0.2f;
 		bDead = false;
 		nBounceBeforeDeath = -1;
 		bStable = false;
-		
-		if (sprWorm == nullptr)		// Loads sprite data from sprite file
-			sprWorm = new olc::Sprite("Sprites/worms1.png");
 	}
 
-	virtual void Draw(olc::PixelGameEngine* engine, float fOffsetX, float fOffsetY, bool bPixel = false)
+	static void SetSprite(const cCompiledSprite* spr)		// Sprite sheet shared by all worms; only the renderer loads and uses it
 	{
-		engine->SetPixelMode(olc::Pixel::MASK);
+		sprWorm = spr;
+	}
 
+	void Draw(const sBand& band, float fOffsetX, float fOffsetY, bool bPixel = false, bool bLowDetail = false)
+	{
 		if (bIsPlayable)		// Draws Worm Sprite with health bar, in its team's colors
 		{
-			engine->DrawPartialSprite(px - fOffsetX - radius, py - fOffsetY - radius, sprWorm, nTeam * 8, 0, 8, 8);
+			sprWorm->DrawCell(band, px - fOffsetX - radius, py - fOffsetY - radius, nTeam, 0);
 
 			for (int i = 0; i < 11 * fHealth; i++)		// Draws health bar for worm
 			{
-				engine->Draw(px - 5 + i - fOffsetX, py + 5 - fOffsetY, olc::BLUE);
-				engine->Draw(px - 5 + i - fOffsetX, py + 6 - fOffsetY, olc::BLUE);
+				band.Draw(px - 5 + i - fOffsetX, py + 5 - fOffsetY, olc::BLUE);
+				band.Draw(px - 5 + i - fOffsetX, py + 6 - fOffsetY, olc::BLUE);
 			}
 		}
 		else		// Draws tombstone sprite for team's color
 		{
-			engine->DrawPartialSprite(px - fOffsetX - radius, py - fOffsetY - radius, sprWorm, nTeam * 8, 8, 8, 8);
+			sprWorm->DrawCell(band, px - fOffsetX - radius, py - fOffsetY - radius, nTeam, 1);
 		}
-
-		engine->SetPixelMode(olc::Pixel::NORMAL);
 	}
 
-	virtual int BounceDeathAction()
+	int BounceDeathAction()
 	{
 		return 0;		// Nothing
 	}
 
-	virtual bool Damage(float d) // Reduce worm's health by said amount
+	bool Damage(float d) // Reduce worm's health by said amount
 	{
 		fHealth -= d;
 		if (fHealth <= 0)		// Worm has died, no longer playable
@@ -291,123 +998,242 @@ public:
 	int nTeam = 0;		// The ID of which team this worm belongs to
 
 private:
-	static olc::Sprite* sprWorm;
+	static const cCompiledSprite* sprWorm;
 };
 
-olc::Sprite* cWorm::sprWorm = nullptr;
+const cCompiledSprite* cWorm::sprWorm = nullptr;
 
-class cTeam		// Defines a group of worms
+bool cPhysicsObject::Damage(float d)
+{
+	switch (nType)
+	{
+	case OBJ_DEBRIS: return static_cast<cDebris*>(this)->Damage(d);
+	case OBJ_MISSILE: return static_cast<cMissile*>(this)->Damage(d);
+	case OBJ_WORM: return static_cast<cWorm*>(this)->Damage(d);
+	default: return true;
+	}
+}
+
+template <class T>
+class cObjectPool		// Owns all objects of one type; slots of dead objects are reused instead of being freed
 {
 public:
-	vector<cWorm*> vecMembers;
-	int nCurrentMember = 0;		// Index into vector for current worms turn
-	int nTeamSize = 0;		// Total number of worms in team
+	template <class... Args>
+	T* Spawn(Args&&... args)
+	{
+		if (vecFree.empty())		// No slot to reuse, so the pool grows; a deque never moves existing objects
+		{
+			dequeStorage.emplace_back(std::forward<Args>(args)...);
+			return &dequeStorage.back();
+		}
 
-	bool IsTeamAlive()		// Iterates though all team members, if any of them have >0 health, return true
+		T* p = vecFree.back();		// Overwrites a dead object with a freshly constructed one
+		vecFree.pop_back();
+		*p = T(std::forward<Args>(args)...);
+		return p;
+	}
+
+	void Recycle(T* p)		// Marks a dead object's slot as free for the next spawn
 	{
-		bool bAllDead = false;
-		for (auto w : vecMembers)
-			bAllDead |= (w->fHealth > 0.0f);
-		return bAllDead;
+		vecFree.push_back(p);
 	}
 
-	cWorm* GetNextMember()		// Returns a pointer to the next team member that is valid for control
+	template <class F>
+	void ForEachAlive(F func)		// Visits every live object in storage order; the call is inlined for the one concrete type
 	{
-		do {
-			nCurrentMember++;
-			if (nCurrentMember >= nTeamSize)
-				nCurrentMember = 0;
-		} while (vecMembers[nCurrentMember]->fHealth <= 0);
-		
-		return vecMembers[nCurrentMember];
+		for (T& o : dequeStorage)
+			if (!o.bDead)
+				func(o);
 	}
+
+private:
+	deque<T> dequeStorage;
+	vector<T*> vecFree;
 };
 
-class Worms : public olc::PixelGameEngine
+struct sPhysicsEvent		// Something that happened during a physics step, handled once the step is over
+{
+	enum EVENT_TYPE
+	{
+		EVT_BOUNCE = 0,		// Object hit the terrain at (fX, fY) with speed fValue
+		EVT_DEATH,			// Object died and is removed at the end of the update
+		EVT_EXPLOSION,		// Crater of radius fValue at (fX, fY) that knocks back and damages objects
+		EVT_DAMAGE			// Object loses fValue health
+	} nType;
+
+	cPhysicsObject* pObject;
+	real_t fX;
+	real_t fY;
+	float fValue;
+};
+
+template <class T, int nCapacity>
+class cRingBuffer		// First in, first out queue in a fixed array that never allocates
 {
 public:
-	Worms()
+	bool Push(const T& item)		// Fails when full, leaving the queue unchanged
 	{
-		sAppName = "Worms";
+		if (nCount == nCapacity)
+			return false;
+		items[(nHead + nCount) % nCapacity] = item;
+		nCount++;
+		return true;
+	}
+
+	bool Pop(T& item)		// Fails when empty
+	{
+		if (nCount == 0)
+			return false;
+		item = items[nHead];
+		nHead = (nHead + 1) % nCapacity;
+		nCount--;
+		return true;
 	}
 
+	int Size() const { return nCount; }
+
 private:
-	// For map size
-	int nMapWidth = 1024;
-	int nMapHeight = 512;
-	char* map = nullptr;
+	T items[nCapacity];
+	int nHead = 0;		// Index of the oldest item
+	int nCount = 0;
+};
 
-	// For camera control
-	float fCameraPosX = 0.0f;
-	float fCameraPosY = 0.0f;
-	float fCameraPosXTarget = 0.0f;
-	float fCameraPosYTarget = 0.0f;
+struct sMatchStats		// Running totals of what has happened in the match, gathered from physics events
+{
+	int nBounces = 0;
+	int nDeaths = 0;
+	int nExplosions = 0;
+	float fDamage = 0.0f;
+	int nEventsLastFrame = 0;
+	int nSubstepsLastFrame = 0;		// Physics steps taken by all objects together
+	int nEventsDropped = 0;		// Events that didn't fit in the queue; non-zero means it should be bigger
+};
 
-	enum GAME_STATE		// State machine for game events
+// Watches frame time and trades visual quality for frame rate when a frame runs over budget. It only changes how
+// the match is shown, never the match itself, so how a match plays out doesn't depend on how fast the machine is
+class cQualityGovernor
+{
+public:
+	void Update(float fElapsedTime)
 	{
-		GS_RESET = 0,
-		GS_GENERATE_TERRAIN = 1,
-		GS_GENERATING_TERRAIN,
-		GS_ALLOCATE_UNITS,
-		GS_ALLOCATING_UNITS,
-		GS_START_PLAY,
-		GS_CAMERA_MODE,
-		GS_GAME_OVER1,
-		GS_GAME_OVER2
-	} nGameState, nNextState;
+		// Smooths frame time so a single slow frame doesn't change anything
+		fAverageFrameTime += (fElapsedTime - fAverageFrameTime) * 0.1f;
 
-	enum AI_STATE		// State machine for AI player control
+		if (fAverageFrameTime > fFrameBudget * 1.1f)		// Over budget; drops a level once it has lasted a moment
+		{
+			fUnderBudgetTime = 0.0f;
+			fOverBudgetTime += fElapsedTime;
+			if (fOverBudgetTime > 0.25f && nLevel < nMaxLevel)
+			{
+				nLevel++;
+				fOverBudgetTime = 0.0f;
+			}
+		}
+		else if (fAverageFrameTime < fFrameBudget * 0.7f)		// Comfortably under budget; restores a level once load has stayed low
+		{
+			fOverBudgetTime = 0.0f;
+			fUnderBudgetTime += fElapsedTime;
+			if (fUnderBudgetTime > 2.0f && nLevel > 0)
+			{
+				nLevel--;
+				fUnderBudgetTime = 0.0f;
+			}
+		}
+		else
+		{
+			fOverBudgetTime = 0.0f;
+			fUnderBudgetTime = 0.0f;
+		}
+	}
+
+	int GetLevel() const { return nLevel; }		// 0 is full quality, higher levels are cheaper
+	float GetAverageFrameTime() const { return fAverageFrameTime; }
+
+	int GetSmokePuffs() const		// Puffs of smoke each explosion leaves; smoke is only for show, so it's the first thing to go
 	{
-		AI_ASSESS_ENVIRONMENT = 0,
-		AI_MOVE,
-		AI_CHOOSE_TARGET,
-		AI_POSITION_FOR_TARGET,
-		AI_AIM,
-		AI_FIRE,
-	} nAIState, nAINextState;
+		static const int nSmokePuffs[nMaxLevel + 1] = { 4, 2, 0, 0 };
+		return nSmokePuffs[nLevel];
+	}
 
-	bool bGameIsStable = false;		// Represents overall stablity of game
-	bool bPlayerHasControl = false;		// Represents whether player has control over character
-	bool bPlayerActionComplete = false;	// Represents whether player has finished an action
+	bool IsLowDetail() const { return nLevel >= 2; }		// Small particles skip rotating their models
 
-	list<unique_ptr<cPhysicsObject>> listObjects;		// Allows multiple types of objects in list; The list of objects in game
+public:
+	float fFrameBudget = 1.0f / 60.0f;		// Time a frame should take, in seconds
 
-	cPhysicsObject* pObjectUnderControl = nullptr;		// Pointer for object under control; Directs user input towards an onject
-	cPhysicsObject* pCameraTrackingObject = nullptr;	// Pointer for object the camera should be following
+private:
+	static const int nMaxLevel = 3;
+	int nLevel = 0;
+	float fAverageFrameTime = 1.0f / 60.0f;
+	float fOverBudgetTime = 0.0f;
+	float fUnderBudgetTime = 0.0f;
+};
 
-	bool bEnergising = false;		// Indicates if user is charging up a shot
-	float fEnergyLevel = 0.0f;		// Amount that's been charged so far
-	bool bFireWeapon = false;		// Trigger that handles firing of weapon
+class cTeam		// Defines a group of worms
+{
+public:
+	vector<cWorm*> vecMembers;
+	int nCurrentMember = 0;		// Index into vector for current worms turn
+	int nTeamSize = 0;		// Total number of worms in team
 
-	float fTurnTime = 0.0f;				// Time left to take your turn
-	bool bZoomOut = false;				// Renders the whole map
-	bool bEnablePlayerControl = true;		// The player is in control, keyboard input enabled
-	bool bEnableComputerControl = false;		// The AI is in control
-	bool bPlayerHasFired = false;			// Weapon has been fired
-	bool bShowCountDown = false;			// Displays turn time counter on screen
+	bool IsTeamAlive()		// Iterates though all team members, if any of them have >0 health, return true
+	{
+		bool bAllDead = false;
+		for (auto w : vecMembers)
+			bAllDead |= (w->fHealth > 0.0f);
+		return bAllDead;
+	}
 
-	vector<cTeam> vecTeams;		// Vector to store teams
+	cWorm* GetNextMember()		// Returns a pointer to the next team member that is valid for control
+	{
+		do {
+			nCurrentMember++;
+			if (nCurrentMember >= nTeamSize)
+				nCurrentMember = 0;
+		} while (vecMembers[nCurrentMember]->fHealth <= 0);
+		
+		return vecMembers[nCurrentMember];
+	}
+};
 
-	int nCurrentTeam = 0;		// Current team being controlled
+struct sTerrainRect		// A region of the map, in map pixels
+{
+	int x;
+	int y;
+	int w;
+	int h;
+};
 
-	// AI control flags
-	bool bAI_Jump = false;			// AI has pressed "JUMP" key
-	bool bAI_AimLeft = false;		// AI has pressed "AIM_LEFT" key
-	bool bAI_AimRight = false;		// AI has pressed "AIM_RIGHT" key
-	bool bAI_Energise = false;		// AI has pressed "FIRE" key
+struct sExplosion		// Where and how big an explosion was, for effects that only the renderer cares about
+{
+	float fX;
+	float fY;
+	float fRadius;
+};
 
+struct sWormDamage		// Health a worm lost and where it was, for the renderer's floating damage numbers
+{
+	float fX;
+	float fY;
+	float fDamage;
+	int nTeam;
+};
 
-	float fAITargetAngle = 0.0f;		// Angle AI should aim for
-	float fAITargetEnergy = 0.0f;		// Energy level AI should aim for
-	float fAISafePosition = 0.0f;		// X-Coordinate considered safe for AI to move to
-	cWorm* pAITargetWorm = nullptr;		// Pointer to worm AI has selected as target
-	float fAITargetX = 0.0f;		// X-Coordinate of target missile location
-	float fAITargetY = 0.0f;		// Y-Coordinate of target missile location
+struct sPlayerInput		// What the human player is doing this frame; a match never reads the keyboard itself
+{
+	bool bJump = false;				// 'Z' pressed
+	bool bAimLeft = false;			// 'A' held
+	bool bAimRight = false;			// 'S' held
+	bool bFirePressed = false;		// Spacebar pressed
+	bool bFireHeld = false;			// Spacebar held
+	bool bFireReleased = false;		// Spacebar released
+};
 
-	virtual bool OnUserCreate()		// Creates the map
+class cMatch		// One game: terrain, objects, teams, turns and AI. Owns all its state, so matches can run side by side
+{
+public:
+	cMatch(unsigned int nSeed = 5489u) : rng(nSeed)
 	{
-		map = new char[nMapWidth * nMapHeight];				// Allocate memory for 2D array
-		memset(map, 0, nMapWidth * nMapHeight * sizeof(char));		// Clear all to 0
+		map.resize(nMapWidth * nMapHeight, 0);		// Clear all to 0
 
 		// State machine creates map
 		nGameState = GS_RESET;
@@ -416,45 +1242,12 @@ private:
 		nAINextState = AI_ASSESS_ENVIRONMENT;
 
 		bGameIsStable = false;
-
-		return true;
 	}
 
-	virtual bool OnUserUpdate(float fElapsedTime)
+	void Update(float fElapsedTime, const sPlayerInput& input)
 	{
-		// Tab key toggles between whole map view and up close view
-		if (GetKey(olc::Key::TAB).bReleased)
-			bZoomOut = !bZoomOut;
-
-		/* Debugging items
-		if (GetKey(olc::Key::M).bReleased)		// Whenever 'M' key is released, generate new map
-			CreateMap();
-
-		if (GetMouse(0).bReleased)		// Lanches debris wherever the left mouse button is released
-			Boom(GetMouseX() + fCameraPosX, GetMouseY() + fCameraPosY, 10.0f);
-		
-		if (GetMouse(1).bReleased)		// Drops a missile wherever the right mouse button is released
-			listObjects.push_back(unique_ptr<cMissile>(new cMissile(GetMouseX() + fCameraPosX, GetMouseY() + fCameraPosY)));
-
-		if (GetMouse(2).bReleased)		// Creates a Worm/unit object wherever the middle mouse button is released
-		{
-			cWorm* worm = new cWorm(GetMouseX() + fCameraPosX, GetMouseY() + fCameraPosY);
-			pObjectUnderControl = worm;
-			pCameraTrackingObject = worm;
-			listObjects.push_back(unique_ptr<cWorm>(worm));
-		}
-		*/
-
-		// Controller camera for mouse edge map scrolling
-		float fMapScrollSpeed = 400.0f;
-		if (GetMouseX() < 5)		// If within 5 pixels on screen edge, move camera position
-			fCameraPosX -= fMapScrollSpeed * fElapsedTime;
-		if (GetMouseX() > ScreenWidth() - 5)
-			fCameraPosX += fMapScrollSpeed * fElapsedTime;
-		if (GetMouseY() < 5)
-			fCameraPosY -= fMapScrollSpeed * fElapsedTime;
-		if (GetMouseY() > ScreenWidth() - 5)
-			fCameraPosY += fMapScrollSpeed * fElapsedTime;
+		stats.nEventsLastFrame = 0;
+		stats.nSubstepsLastFrame = 0;
 
 		// Control supervisor
 		switch (nGameState)
@@ -507,9 +1300,8 @@ private:
 					float fWormY = 0.0f;
 
 					// Add worms to teams
-					cWorm* worm = new cWorm(fWormX, fWormY);
+					cWorm* worm = Spawn(poolWorms, fWormX, fWormY);
 					worm->nTeam = t;
-					listObjects.push_back(unique_ptr<cWorm>(worm));
 					vecTeams[t].vecMembers.push_back(worm);
 					vecTeams[t].nTeamSize = nWormsPerTeam;
 				}
@@ -529,8 +1321,8 @@ private:
 		{
 			if (bGameIsStable)
 			{
-				bEnablePlayerControl = true;
-				bEnableComputerControl = false;
+				bEnablePlayerControl = bHumanPlayer;
+				bEnableComputerControl = !bHumanPlayer;
 				fTurnTime = 15.0f;
 				bZoomOut = false;
 				nNextState = GS_START_PLAY;
@@ -558,17 +1350,26 @@ private:
 
 			if (bGameIsStable)		// Once settled, chooses the next worm
 			{
-				// Gets next team, if there is no next team, game is over
+				// Gets next team, if there is no next team, game is over; gives up after one lap in case nobody is left
 				int nOldTeam = nCurrentTeam;
-				do {
+				for (size_t i = 0; i < vecTeams.size(); i++)
+				{
 					nCurrentTeam++;
 					nCurrentTeam %= vecTeams.size();
-				} while (!vecTeams[nCurrentTeam].IsTeamAlive());
+					if (vecTeams[nCurrentTeam].IsTeamAlive())
+						break;
+				}
+
+				if (!vecTeams[nCurrentTeam].IsTeamAlive())		// Nobody is left at all, so there's no worm to hand over to
+				{
+					nWinningTeam = -1;
+					nNextState = GS_GAME_OVER1;
+					break;
+				}
 
 				// Locks controls if AI team is currently playing
-				if (nCurrentTeam == 0)		// The Player Team
+				if (nCurrentTeam == 0 && bHumanPlayer)		// The Player Team
 				{
-					// Swap these around for a complete AI battle
 					bEnablePlayerControl = true;
 					bEnableComputerControl = false;
 				}
@@ -586,7 +1387,10 @@ private:
 				nNextState = GS_START_PLAY;
 
 				if (nCurrentTeam == nOldTeam)		// If no different team could be found, game is over, current team wins
+				{
+					nWinningTeam = nCurrentTeam;
 					nNextState = GS_GAME_OVER1;
+				}
 			}
 		}
 		break;
@@ -600,9 +1404,9 @@ private:
 
 			for (int i = 0; i < 100; i++)
 			{
-				int nBombX = rand() % nMapWidth;
-				int nBombY = rand() % (nMapHeight / 2);
-				listObjects.push_back(std::unique_ptr<cMissile>(new cMissile(nBombX, nBombY, 0.0f, 0.5f)));
+				int nBombX = Random() % nMapWidth;
+				int nBombY = Random() % (nMapHeight / 2);
+				Spawn(poolMissiles, (float)nBombX, (float)nBombY, 0.0f, 0.5f);
 			}
 
 			nNextState = GS_GAME_OVER2;
@@ -625,7 +1429,7 @@ private:
 			case AI_ASSESS_ENVIRONMENT:
 			{
 
-				int nAction = rand() % 3;
+				int nAction = Random() % 3;
 				if (nAction == 0)		// Plays defensively; Moves away from team
 				{
 					// Finds nearest ally, then walks away from them
@@ -701,11 +1505,22 @@ private:
 
 				// Select a team that is not itself
 				cWorm* origin = (cWorm*)pObjectUnderControl;
-				int nCurrentTeam = origin->nTeam;
+				bool bTargetLeft = false;
+				for (int t = 0; t < (int)vecTeams.size(); t++)
+					bTargetLeft |= t != origin->nTeam && vecTeams[t].IsTeamAlive();
+
+				if (!bTargetLeft)		// Everyone else died during this turn, so there's nothing left to do
+				{
+					fTurnTime = 0.0f;
+					bEnableComputerControl = false;
+					nAINextState = AI_ASSESS_ENVIRONMENT;
+					break;
+				}
+
 				int nTargetTeam = 0;
 				do {
-					nTargetTeam = rand() % vecTeams.size();
-				} while (nTargetTeam == nCurrentTeam || !vecTeams[nTargetTeam].IsTeamAlive());
+					nTargetTeam = Random() % vecTeams.size();
+				} while (nTargetTeam == origin->nTeam || !vecTeams[nTargetTeam].IsTeamAlive());
 
 				// The aggressive strategy is to aim for the opponent unit with the most health
 				cWorm* mostHealthyWorm = vecTeams[nTargetTeam].vecMembers[0];
@@ -828,7 +1643,7 @@ private:
 			}
 		}
 
-		
+
 		fTurnTime -= fElapsedTime;			// Decreases turn time
 
 		if (pObjectUnderControl != nullptr)		// If not null, then pointing to a worm
@@ -838,19 +1653,19 @@ private:
 			if (pObjectUnderControl->bStable)	// Ensures user input applies only when object is stable
 			{
 				// When 'Z' is pressed, worm jumps in the aimed direction, if player is in control; If computer is in control, AI jumps
-				if ((bEnablePlayerControl && GetKey(olc::Key::Z).bPressed) || (bEnableComputerControl && bAI_Jump))
+				if ((bEnablePlayerControl && input.bJump) || (bEnableComputerControl && bAI_Jump))
 				{
 					float a = ((cWorm*)pObjectUnderControl)->fShootAngle;
 
-					pObjectUnderControl->vx = 4.0f * cosf(a);
-					pObjectUnderControl->vy = 8.0f * sinf(a);
+					pObjectUnderControl->vx = 4.0f * RealCos(a);
+					pObjectUnderControl->vy = 8.0f * RealSin(a);
 					pObjectUnderControl->bStable = false;
 
 					bAI_Jump = false;
 				}
 
 				// When 'A' is held, cursor turns counter-clockwise if player is in control; If computer is in control, AI aims left
-				if ((bEnablePlayerControl && GetKey(olc::Key::A).bHeld) || (bEnableComputerControl && bAI_AimLeft))
+				if ((bEnablePlayerControl && input.bAimLeft) || (bEnableComputerControl && bAI_AimLeft))
 				{
 					cWorm* worm = (cWorm*)pObjectUnderControl;
 					worm->fShootAngle -= 1.0f * fElapsedTime;
@@ -860,7 +1675,7 @@ private:
 				}
 
 				// When 'S' is held, cursor turns clockwise if player is in control; If computer is in control, AI aims right
-				if ((bEnablePlayerControl && GetKey(olc::Key::S).bHeld) || (bEnableComputerControl && bAI_AimRight))
+				if ((bEnablePlayerControl && input.bAimRight) || (bEnableComputerControl && bAI_AimRight))
 				{
 					cWorm* worm = (cWorm*)pObjectUnderControl;
 					worm->fShootAngle += 1.0f * fElapsedTime;
@@ -869,7 +1684,7 @@ private:
 						worm->fShootAngle -= 3.14159f * 2.0f;
 				}
 
-				if ((bEnablePlayerControl && GetKey(olc::Key::SPACE).bPressed))		// When spacebar is pressed, start charging weapon, if player is in control
+				if ((bEnablePlayerControl && input.bFirePressed))		// When spacebar is pressed, start charging weapon, if player is in control
 				{
 					bEnergising = true;
 					bFireWeapon = false;
@@ -877,7 +1692,7 @@ private:
 				}
 
 				// When spacebar is being held down, increse weapon charge if player is in control; If computer is in control, AI charges weapon
-				if ((bEnablePlayerControl && GetKey(olc::Key::SPACE).bHeld) || (bEnableComputerControl && bAI_Energise))		
+				if ((bEnablePlayerControl && input.bFireHeld) || (bEnableComputerControl && bAI_Energise))
 				{
 					if (bEnergising)
 					{
@@ -890,7 +1705,7 @@ private:
 					}
 				}
 
-				if ((bEnablePlayerControl && GetKey(olc::Key::SPACE).bReleased))		// When spacebar is released, fire weapon if player is in control
+				if ((bEnablePlayerControl && input.bFireReleased))		// When spacebar is released, fire weapon if player is in control
 				{
 					if (bEnergising)		// While being charged up, as soon as released, weapon fires
 						bFireWeapon = true;
@@ -904,16 +1719,15 @@ private:
 				cWorm* worm = (cWorm*)pObjectUnderControl;
 
 				// Gets weapon origin
-				float ox = worm->px;
-				float oy = worm->py;
+				real_t ox = worm->px;
+				real_t oy = worm->py;
 
 				// Gets weapon direction
-				float dx = cosf(worm->fShootAngle);
-				float dy = sinf(worm->fShootAngle);
+				real_t dx = RealCos(worm->fShootAngle);
+				real_t dy = RealSin(worm->fShootAngle);
 
 				// Creates weapon object and adds it to the object list
-				cMissile* m = new cMissile(ox, oy, dx * 40.0f * fEnergyLevel, dy * 40.0f * fEnergyLevel);
-				listObjects.push_back(unique_ptr<cMissile>(m));
+				cMissile* m = Spawn(poolMissiles, ox, oy, dx * 40.0f * fEnergyLevel, dy * 40.0f * fEnergyLevel);
 				pCameraTrackingObject = m;		// Makes camera track missile
 
 
@@ -923,289 +1737,161 @@ private:
 				bEnergising = false;
 				bPlayerHasFired = true;
 
-				if (rand() % 100 >= 50)
+				if (Random() % 100 >= 50)
 					bZoomOut = true;
 			}
 		}
 
-		if (pCameraTrackingObject != nullptr)		// Move camera automatically if tracking object isn't null
+#if defined(WORMS_FIXED_POINT)
+		// Fixed point physics advances in ticks of a fixed length, so the result doesn't depend on the frame rate
+		fPhysicsTimeAccumulator = min(fPhysicsTimeAccumulator + fElapsedTime, fPhysicsTick * nMaxPhysicsTicks);
+		while (fPhysicsTimeAccumulator >= fPhysicsTick)
 		{
-			// Makes camera's current position slowly inerpolate between current and target position
-			fCameraPosXTarget = pCameraTrackingObject->px - ScreenWidth() / 2;
-			fCameraPosYTarget = pCameraTrackingObject->py - ScreenHeight() / 2;
-			fCameraPosX += (fCameraPosXTarget - fCameraPosX) * 15.0f * fElapsedTime;
-			fCameraPosY += (fCameraPosYTarget - fCameraPosY) * 15.0f * fElapsedTime;
+			UpdatePhysics(cFixed::FromRaw(nPhysicsTickRaw));
+			fPhysicsTimeAccumulator -= fPhysicsTick;
 		}
+		if (!vecSpawned.empty())		// Above the tick rate some frames run no tick, but what they spawn is still in play
+			UpdateObjectList();
+#else
+		UpdatePhysics(fElapsedTime);
+#endif
 
-		// Clamp map boundaries to keep camera in bounds
-		if (fCameraPosX < 0)
-			fCameraPosX = 0;
-		if (fCameraPosX >= nMapWidth - ScreenWidth())
-			fCameraPosX = nMapWidth - ScreenWidth();
-		if (fCameraPosY < 0)
-			fCameraPosY = 0;
-		if (fCameraPosY >= nMapHeight - ScreenHeight())
-			fCameraPosY = nMapHeight - ScreenHeight();
-
-		for (int z = 0; z < 10; z++)		// Does 10 physics iterations/frame for accurate, controllable calculations
-		{
-			for (auto& p : listObjects)		// Updates physics of all physical objects
+		// Checks for game state stability
+		bGameIsStable = true;
+		for (auto p : vecObjects)		// Iterates through all objects and checks if stable
+			if (!p->bStable)
 			{
-				// Applies gravity
-				p->ay += 2.0f;
+				bGameIsStable = false;
+				break;
+			}
 
-				// Updates velocity
-				p->vx += p->ax * fElapsedTime;
-				p->vy += p->ay * fElapsedTime;
+		fMatchTime += fElapsedTime;
+		nGameState = nNextState;
+		nAIState = nAINextState;
+	}
 
-				// Updates potential future position
-				float fPotentialX = p->px + p->vx * fElapsedTime;
-				float fPotentialY = p->py + p->vy * fElapsedTime;
+	bool IsOver() const { return nGameState == GS_GAME_OVER1 || nGameState == GS_GAME_OVER2; }
+	int GetWinningTeam() const { return nWinningTeam; }		// -1 while playing, or if nobody survived
+	float GetMatchTime() const { return fMatchTime; }
 
-				// Resets acceleration and stability
-				p->ax = 0.0f;
-				p->ay = 0.0f;
-				p->bStable = false;
+public:
+	// Read by whoever draws the match
+	int nMapWidth = 1024;
+	int nMapHeight = 512;
+	vector<char> map;
+	vector<sTerrainRect> vecTerrainChanges;		// Regions of map changed since whoever draws the match last cleared this
+	vector<sExplosion> vecExplosions;		// Explosions since whoever draws the match last cleared this; only the latest few are kept
+	vector<sWormDamage> vecWormDamage;		// Same, for damage done to worms
 
-				// Checks colision with the map 
-				float fAngle = atan2f(p->vy, p->vx);		
-				float fResponseX = 0;
-				float fResponseY = 0;
-				bool bCollision = false;
+	vector<cPhysicsObject*> vecObjects;		// Allows multiple types of objects in list; The list of objects in game
+	vector<cTeam> vecTeams;		// Vector to store teams
 
-				// Iterates though a semicircle of an object's radius that's rotated towards the direction of travel
-				for (float r = fAngle - 3.14159f / 2.0f; r < fAngle + 3.14159f / 2.0f; r += 3.14159f / 4.0f)
-				{
-					// Calculates the test point on circumference of circle
-					float fTestPosX = (p->radius) * cosf(r) + fPotentialX;
-					float fTestPosY = (p->radius) * sinf(r) + fPotentialY;
-
-					// Constrains to test within the map's boundary
-					if (fTestPosX >= nMapWidth) fTestPosX = nMapWidth - 1;
-					if (fTestPosY >= nMapHeight) fTestPosX = nMapHeight - 1;
-					if (fTestPosX < 0) fTestPosX = 0;
-					if (fTestPosY < 0) fTestPosY = 0;
-
-					// Tests if any of the points on an object's semicircle intersects with the terrain
-					if (map[(int)fTestPosY * nMapWidth + (int)fTestPosX] > 0)
-					{
-						// Accumulates collision points to define the normal vector for escape response
-						fResponseX += fPotentialX - fTestPosX;
-						fResponseY += fPotentialY - fTestPosY;
-						bCollision = true;
-					}
-				}
+	cPhysicsObject* pObjectUnderControl = nullptr;		// Pointer for object under control; Directs user input towards an onject
+	cPhysicsObject* pCameraTrackingObject = nullptr;	// Pointer for object the camera should be following
+	bool bZoomOut = false;				// The whole map should be shown
+	bool bShowCountDown = false;			// Displays turn time counter on screen
+	float fTurnTime = 0.0f;				// Time left to take your turn
+	float fEnergyLevel = 0.0f;		// Amount that's been charged so far
 
-				// Calculates magnitudes of response and velocity vectors
-				float fMagVelocity = sqrtf(p->vx * p->vx + p->vy * p->vy);
-				float fMagResponse = sqrtf(fResponseX * fResponseX + fResponseY * fResponseY);
+	sMatchStats stats;
 
-				if (p->px < 0 || p->px > nMapWidth || p->py <0 || p->py > nMapHeight)
-					p->bDead = true;
+	// Set up by whoever runs the match
+	bool bHumanPlayer = true;		// Team 0 is played from sPlayerInput; otherwise the AI plays every team
 
-				// Finds angle of collision
-				if (bCollision)		// If collision has occured, respond
-				{
-					p->bStable = true;
-												
-					// Calculates reflection vector of objects velocity vector, using response vector as normal
-					float dot = p->vx * (fResponseX / fMagResponse) + p->vy * (fResponseY / fMagResponse);
+private:
+	friend class cMatchTest;		// Tests.cpp checks the physics from inside
 
-					// Uses the friction coefficient to dampen response (approximates energy loss)
-					p->vx = p->fFriction * (-2.0f * dot * (fResponseX / fMagResponse) + p->vx);
-					p->vy = p->fFriction * (-2.0f * dot * (fResponseY / fMagResponse) + p->vy);
+	enum GAME_STATE		// State machine for game events
+	{
+		GS_RESET = 0,
+		GS_GENERATE_TERRAIN = 1,
+		GS_GENERATING_TERRAIN,
+		GS_ALLOCATE_UNITS,
+		GS_ALLOCATING_UNITS,
+		GS_START_PLAY,
+		GS_CAMERA_MODE,
+		GS_GAME_OVER1,
+		GS_GAME_OVER2
+	} nGameState, nNextState;
 
-					if (p->nBounceBeforeDeath > 0)		// Makes some objects 'die' after several bounces
-					{
-						p->nBounceBeforeDeath--;
-						p->bDead = p->nBounceBeforeDeath == 0;
+	enum AI_STATE		// State machine for AI player control
+	{
+		AI_ASSESS_ENVIRONMENT = 0,
+		AI_MOVE,
+		AI_CHOOSE_TARGET,
+		AI_POSITION_FOR_TARGET,
+		AI_AIM,
+		AI_FIRE,
+	} nAIState, nAINextState;
 
-						if (p->bDead)		// Action upon an objects death; If greater than 0, creates an explosion
-						{
-							int nResponse = p->BounceDeathAction();
-							if (nResponse > 0)
-							{
-								Boom(p->px, p->py, nResponse);
-								pCameraTrackingObject = nullptr;		// After debris settles, camera goes back to player
-							}
-						}
+	mt19937 rng;		// Each match has its own random numbers, so matches don't disturb one another
 
-					}
-				}
-				else		// Else allow it to use the new potential positions
-				{
-					// Updates objects position with potential (x,y) coordinates
-					p->px = fPotentialX;
-					p->py = fPotentialY;
-				}
+	bool bGameIsStable = false;		// Represents overall stablity of game
+	bool bPlayerHasControl = false;		// Represents whether player has control over character
+	bool bPlayerActionComplete = false;	// Represents whether player has finished an action
 
-				// Makes objects stop moving when velocity is low
-				if (fMagVelocity < 0.1f)
-					p->bStable = true;
-			}
-			// Removes objects from list if dead flag is true; Because it is a unique ptr, will go out of scope and automatically delete
-			listObjects.remove_if([](unique_ptr<cPhysicsObject>& o) {return o->bDead;});
-		}
+	vector<cPhysicsObject*> vecSpawned;		// Objects created during a frame, added to the list once physics is done with it
 
-		// Draws landscape terrain
-		if (!bZoomOut)
-		{
-			for (int x = 0; x < ScreenWidth(); x++)		// Iterate through all pixels on screen
-				for (int y = 0; y < ScreenHeight(); y++)
-				{
-					switch (map[(y + (int)fCameraPosY) * nMapWidth + (x + (int)fCameraPosX)])		// Finds location in map & colors in for sky or terrain
-					{
-					// Sky radiants
-					case -8: Draw(x, y, olc::VERY_DARK_CYAN); break;		
-					case -7: Draw(x, y, olc::DARK_CYAN); break;
-					case -6: Draw(x, y, olc::DARK_CYAN); break;
-					case -5: Draw(x, y, olc::BLUE); break;
-					case -4: Draw(x, y, olc::DARK_BLUE); break;
-					case -3: Draw(x, y, olc::DARK_BLUE); break;
-					case -2: Draw(x, y, olc::VERY_DARK_BLUE); break;
-					case -1: Draw(x, y, olc::VERY_DARK_BLUE); break;
-						
-					// Simple sky
-					case  0: Draw(x, y, olc::CYAN); break;
-						
-					// Land
-					case  1: Draw(x, y, olc::DARK_GREEN); break;			
-					}
-				}
+	// The object list split by type, each in list order, so physics steps one type at a time with direct calls
+	vector<cWorm*> vecWormsInPlay;
+	vector<cMissile*> vecMissilesInPlay;
+	vector<cDebris*> vecDebrisInPlay;
 
-			for (auto& p : listObjects)		// Draws Objects
-			{
-				p->Draw(this, fCameraPosX, fCameraPosY);
-				cWorm* worm = (cWorm*)pObjectUnderControl;
+	bool bEnergising = false;		// Indicates if user is charging up a shot
+	bool bFireWeapon = false;		// Trigger that handles firing of weapon
 
-				if (p.get() == worm)		// If object is current worm under control, draws cursor
-				{
-					// Finds centerpoint of crosshair
-					float cx = worm->px + 8.0f * cosf(worm->fShootAngle) - fCameraPosX;
-					float cy = worm->py + 8.0f * sinf(worm->fShootAngle) - fCameraPosY;
-
-					// Draws a '+' symbol for the cursor
-					Draw(cx, cy, olc::BLACK);
-					Draw(cx + 1, cy, olc::BLACK);
-					Draw(cx - 1, cy, olc::BLACK);
-					Draw(cx, cy + 1, olc::BLACK);
-					Draw(cx, cy - 1, olc::BLACK);
-
-					for (int i = 0; i < 11 * fEnergyLevel; i++)		// Draws an energy bar, indicating how much energy the weapon will be fired with
-					{
-						Draw(worm->px - 5 + i - fCameraPosX, worm->py - 12 - fCameraPosY, olc::GREEN);
-						Draw(worm->px - 5 + i - fCameraPosX, worm->py - 11 - fCameraPosY, olc::RED);
-					}
-				}
-			}
-		}
-		else
-		{
-			for (int x = 0; x < ScreenWidth(); x++)
-				for (int y = 0; y < ScreenHeight(); y++)
-				{
-					float fx = (float)x / (float)ScreenWidth() * (float)nMapWidth;
-					float fy = (float)y / (float)ScreenHeight() * (float)nMapHeight;
-
-					switch (map[(int)fy * nMapWidth + (int)fx])
-					{
-					// Sky radiants
-					case -8: Draw(x, y, olc::VERY_DARK_CYAN); break;
-					case -7: Draw(x, y, olc::DARK_CYAN); break;
-					case -6: Draw(x, y, olc::DARK_CYAN); break;
-					case -5: Draw(x, y, olc::BLUE); break;
-					case -4: Draw(x, y, olc::DARK_BLUE); break;
-					case -3: Draw(x, y, olc::DARK_BLUE); break;
-					case -2: Draw(x, y, olc::VERY_DARK_BLUE); break;
-					case -1: Draw(x, y, olc::VERY_DARK_BLUE); break;
-						
-					// Simple sky	
-					case  0: Draw(x, y, olc::CYAN); break;
-
-					// Land
-					case  1: Draw(x, y, olc::DARK_GREEN); break;
-					}
-				}
+	bool bEnablePlayerControl = true;		// The player is in control, keyboard input enabled
+	bool bEnableComputerControl = false;		// The AI is in control
+	bool bPlayerHasFired = false;			// Weapon has been fired
 
-			for (auto& p : listObjects)
-				p->Draw(this, p->px - (p->px / (float)nMapWidth) * (float)ScreenWidth(),
-					p->py - (p->py / (float)nMapHeight) * (float)ScreenHeight(), true);
-		}
+	cRingBuffer<sPhysicsEvent, 1024> events;		// Filled by physics steps, emptied after each one
 
-		// Checks for game state stability
-		bGameIsStable = true;
-		for(auto &p : listObjects)		// Iterates through all objects and checks if stable
-			if (!p->bStable)
-			{
-				bGameIsStable = false;
-				break;
-			}
+#if defined(WORMS_FIXED_POINT)
+	const int32_t nPhysicsTickRaw = 65536 / 60;		// Length of a physics tick, in fixed point seconds
+	const float fPhysicsTick = (float)nPhysicsTickRaw / 65536.0f;
+	const int nMaxPhysicsTicks = 4;		// Slow frames drop time rather than running ever more ticks
+	float fPhysicsTimeAccumulator = 0.0f;		// Frame time not yet simulated
+#endif
 
-		/* Marker for debugging purposes		
-		if (bGameIsStable)
-			FillRect(2, 2, 4, 4, olc::RED);
-		*/
-		
-		for (size_t t = 0; t < vecTeams.size(); t++)		// Draws team health bars
-		{
-			float fTotalHealth = 0.0f;
-			float fMaxHealth = (float)vecTeams[t].nTeamSize;
-			for (auto w : vecTeams[t].vecMembers)		// Accumulates team health
-				fTotalHealth += w->fHealth;
+	int nCurrentTeam = 0;		// Current team being controlled
+	int nWinningTeam = -1;
+	float fMatchTime = 0.0f;		// Time played so far, in seconds
 
-			olc::Pixel cols[] = { olc::RED, olc::BLUE, olc::MAGENTA, olc::GREEN };
-			FillRect(4, 4 + t * 4, (fTotalHealth / fMaxHealth) * (float)(ScreenWidth() - 8), 3, cols[t]);
-		}
+	// AI control flags
+	bool bAI_Jump = false;			// AI has pressed "JUMP" key
+	bool bAI_AimLeft = false;		// AI has pressed "AIM_LEFT" key
+	bool bAI_AimRight = false;		// AI has pressed "AIM_RIGHT" key
+	bool bAI_Energise = false;		// AI has pressed "FIRE" key
 
-		// Counts down using 7 segment display
-		if (bShowCountDown) {
-			int tx = 4;
-			int ty = vecTeams.size() * 4 + 8;
-			int nCountDown = round(fTurnTime);
-			if (nCountDown < 10) {
-				SevenSegmentDisplay(tx, ty, nCountDown, olc::DARK_GREY, 2);
-			}
-		}
 
-		nGameState = nNextState;
-		nAIState = nAINextState;
+	float fAITargetAngle = 0.0f;		// Angle AI should aim for
+	float fAITargetEnergy = 0.0f;		// Energy level AI should aim for
+	float fAISafePosition = 0.0f;		// X-Coordinate considered safe for AI to move to
+	cWorm* pAITargetWorm = nullptr;		// Pointer to worm AI has selected as target
+	float fAITargetX = 0.0f;		// X-Coordinate of target missile location
+	float fAITargetY = 0.0f;		// Y-Coordinate of target missile location
 
-		return true;
+	int Random()		// Random number from 0 to 2^31 - 1, in place of rand()
+	{
+		return (int)(rng() >> 1);
 	}
 
-	void SevenSegmentDisplay(int x, int y, int digit, olc::Pixel col = olc::WHITE, int scale = 1)
+	float RandomFloat()		// Random number from 0 up to, but not including, 1
 	{
-		// Encodes which segment is active per digit
-		char segmentCode[10] = {
-			// For digit '0' the segments 0, 1, 2, 4, 5, 6 are active
-			0b01110111,
-			0b00100100,
-			0b01011101,
-			0b01101101,
-			0b00101110,
-			0b01101011,
-			0b01111011,
-			0b00100101,
-			0b01111111,
-			0b01101111,
-		};
-
-		// Checks if the bit at cByte[nIndex] is set
-		auto is_bit_active = [=](char cByte, int nIndex) -> bool {
-			return ((cByte >> nIndex) & 0x01) == 0x01;
-			};
+		return (float)(rng() >> 8) / 16777216.0f;
+	}
 
-		// Draws the segments in a 8x8 grid
-		if (is_bit_active(segmentCode[digit], 0)) FillRect(x + (1 * scale), y, 4 * scale, 1 * scale, col);
-		if (is_bit_active(segmentCode[digit], 1)) FillRect(x, y + (1 * scale), 1 * scale, 3 * scale, col);
-		if (is_bit_active(segmentCode[digit], 2)) FillRect(x + (5 * scale), y + (1 * scale), 1 * scale, 3 * scale, col);
-		if (is_bit_active(segmentCode[digit], 3)) FillRect(x + (1 * scale), y + (4 * scale), 4 * scale, 1 * scale, col);
-		if (is_bit_active(segmentCode[digit], 4)) FillRect(x, y + (5 * scale), 1 * scale, 3 * scale, col);
-		if (is_bit_active(segmentCode[digit], 5)) FillRect(x + (5 * scale), y + (5 * scale), 1 * scale, 3 * scale, col);
-		if (is_bit_active(segmentCode[digit], 6)) FillRect(x + (1 * scale), y + (8 * scale), 4 * scale, 1 * scale, col);
+public:
+	// Game actions, also handy for debugging
+	template <class T, class... Args>
+	T* Spawn(cObjectPool<T>& pool, Args&&... args)		// Creates an object in its pool; it joins the object list at the end of the frame
+	{
+		T* p = pool.Spawn(std::forward<Args>(args)...);
+		vecSpawned.push_back(p);
+		return p;
 	}
 
-	void Boom(float fWorldX, float fWorldY, float fRadius)		// Launches debris
+	void Boom(real_t fWorldX, real_t fWorldY, real_t fRadius)		// Launches debris
 	{
 		auto CircleBresenham = [&](int xc, int yc, int r)	// Bresenham's midpoint circle algorithm sourced from Wikipedia
 		{
@@ -1233,16 +1919,20 @@ private:
 			}
 		};
 
-		int bx = (int)fWorldX;
-		int by = (int)fWorldY;
+		int bx = ToInt(fWorldX);
+		int by = ToInt(fWorldY);
 
-		CircleBresenham(fWorldX, fWorldY, fRadius);		// Erases terrain to form a crater
+		CircleBresenham(bx, by, ToInt(fRadius));		// Erases terrain to form a crater
+		MarkTerrainChanged({ bx - ToInt(fRadius), by - ToInt(fRadius), 2 * ToInt(fRadius) + 1, 2 * ToInt(fRadius) + 1 });
 
-		for (auto& p : listObjects)		// Knocks back other objects in range using Pythagorean Theorem
+		for (auto p : vecObjects)		// Knocks back other objects in range using Pythagorean Theorem
 		{
-			float dx = p->px - fWorldX;
-			float dy = p->py - fWorldY;
-			float fDist = sqrt(dx * dx + dy * dy);
+			if (p->bDead)
+				continue;
+
+			real_t dx = p->px - fWorldX;
+			real_t dy = p->py - fWorldY;
+			real_t fDist = RealLength(dx, dy);
 
 			if (fDist < 0.0001f) fDist = 0.0001f;		// Prevents possible division by zero
 
@@ -1250,13 +1940,35 @@ private:
 			{
 				p->vx = (dx / fDist) * fRadius;
 				p->vy = (dy / fDist) * fRadius;
-				p->Damage(((fRadius - fDist) / fRadius) * 0.8f);
+				PushEvent({ sPhysicsEvent::EVT_DAMAGE, p, p->px, p->py, ((fRadius - fDist) / fRadius) * 0.8f });
+			}
+
+			if (fDist < fRadius + p->radius + 1.0f)		// Wakes anything the blast or the crater could have moved
+			{
 				p->bStable = false;
+
+				// A sleeping object hasn't moved yet this frame, so it takes part in every iteration that's left, one
+				// iteration's worth of time each. Awake objects keep their schedule, as they may already have covered
+				// the whole frame
+				if (p->nSubsteps == 0)
+					p->nSubsteps = 10;
 			}
 		}
 
-		for (int i = 0; i < (int)fRadius; i++)		// Radius allows big explosions to make lots of debris and small ones to make fewer
-			listObjects.push_back(unique_ptr<cDebris>(new cDebris(fWorldX, fWorldY)));
+		// Radius allows big explosions to make lots of debris and small ones to make fewer
+		int nDebris = ToInt(fRadius);
+		for (int i = 0; i < nDebris; i++)
+		{
+			// Sends each piece off in a random direction and size to make a "boom" effect
+#if defined(WORMS_FIXED_POINT)
+			real_t vx = 10 * cFixed::FromRaw(TableCos(Random() % nAngleSteps));
+			real_t vy = 10 * cFixed::FromRaw(TableSin(Random() % nAngleSteps));
+#else
+			real_t vx = 10.0f * cosf(RandomFloat() * 2.0f * 3.14159f);
+			real_t vy = 10.0f * sinf(RandomFloat() * 2.0f * 3.14159f);
+#endif
+			Spawn(poolDebris, fWorldX, fWorldY, vx, vy);
+		}
 	}
 
 	void CreateMap()
@@ -1266,7 +1978,7 @@ private:
 		float* fNoiseSeed = new float[nMapWidth];
 
 		for (int i = 0; i < nMapWidth; i++)		// Generates noise for map generation
-			fNoiseSeed[i] = (float)rand() / (float)RAND_MAX;
+			fNoiseSeed[i] = RandomFloat();
 
 		fNoiseSeed[0] = 0.5f;		// Terrain will start & end halfway up screen
 		PerlinNoise1D(nMapWidth, fNoiseSeed, 8, 2.0f, fSurface);
@@ -1288,6 +2000,346 @@ private:
 
 		delete[] fSurface;
 		delete[] fNoiseSeed;
+
+		MarkTerrainChanged({ 0, 0, nMapWidth, nMapHeight });
+	}
+
+	// Storage for every object in the game, one pool per type
+	cObjectPool<cDebris> poolDebris;
+	cObjectPool<cMissile> poolMissiles;
+	cObjectPool<cWorm> poolWorms;
+
+private:
+	void PushEvent(const sPhysicsEvent& e)
+	{
+		if (!events.Push(e))
+			stats.nEventsDropped++;
+	}
+
+	// Consumers of physics events; anything an event leads to, including more events, is handled in the same pass
+	void HandlePhysicsEvents()
+	{
+		sPhysicsEvent e;
+		while (events.Pop(e))
+		{
+			stats.nEventsLastFrame++;
+			switch (e.nType)
+			{
+			case sPhysicsEvent::EVT_BOUNCE:
+				stats.nBounces++;
+				break;
+
+			case sPhysicsEvent::EVT_DEATH:
+				stats.nDeaths++;
+				break;
+
+			case sPhysicsEvent::EVT_EXPLOSION:
+				stats.nExplosions++;
+				Boom(e.fX, e.fY, e.fValue);
+				if (vecExplosions.size() >= 16)		// Nobody clears the list in a headless match
+					vecExplosions.erase(vecExplosions.begin());
+				vecExplosions.push_back({ (float)e.fX, (float)e.fY, e.fValue });
+				pCameraTrackingObject = nullptr;		// After debris settles, camera goes back to player
+				break;
+
+			case sPhysicsEvent::EVT_DAMAGE:
+				stats.fDamage += e.fValue;
+				if (e.pObject->nType == cPhysicsObject::OBJ_WORM)
+				{
+					if (vecWormDamage.size() >= 16)
+						vecWormDamage.erase(vecWormDamage.begin());
+					vecWormDamage.push_back({ (float)e.fX, (float)e.fY, e.fValue, ((cWorm*)e.pObject)->nTeam });
+				}
+				e.pObject->Damage(e.fValue);
+				break;
+			}
+		}
+	}
+
+	void MarkTerrainChanged(sTerrainRect r)		// Records a changed region, clipped to the map, for the renderer's caches
+	{
+		int x2 = min(r.x + r.w, nMapWidth), y2 = min(r.y + r.h, nMapHeight);
+		r.x = max(r.x, 0);
+		r.y = max(r.y, 0);
+		r.w = x2 - r.x;
+		r.h = y2 - r.y;
+		if (r.w <= 0 || r.h <= 0)
+			return;
+
+		// Nobody clears the list in a headless match, so past a few dozen regions they are merged into their bounds
+		if (vecTerrainChanges.size() >= 32)
+		{
+			for (const sTerrainRect& o : vecTerrainChanges)
+			{
+				x2 = max(x2, o.x + o.w);
+				y2 = max(y2, o.y + o.h);
+				r.x = min(r.x, o.x);
+				r.y = min(r.y, o.y);
+			}
+			r.w = x2 - r.x;
+			r.h = y2 - r.y;
+			vecTerrainChanges.clear();
+		}
+		vecTerrainChanges.push_back(r);
+	}
+
+	// Number of a frame's 10 physics iterations an object takes part in, each one covering 10 / n iterations' worth
+	// of time: enough that it moves no further than its own radius per substep, rounded up to a divisor of 10.
+	// Objects resting on the terrain sleep until something wakes them
+	int ChooseSubsteps(cPhysicsObject* p, real_t fElapsedTime)
+	{
+		real_t fSpeed = RealLength(p->vx, p->vy);
+		if (p->bStable && p->bTouchingTerrain && fSpeed < 0.1f)
+			return 0;
+
+		int nNeeded = CeilToInt(fSpeed * fElapsedTime * 10 / p->radius);
+
+		static const int nDivisors[] = { 1, 2, 5, 10 };
+		for (int n : nDivisors)
+			if (n >= nNeeded)
+				return n;
+		return 10;
+	}
+
+	// Moves every object through one frame's worth of physics iterations
+	void UpdatePhysics(real_t fElapsedTime)
+	{
+		// Decided once per frame, so every awake object still moves by the same total time
+		for (auto p : vecObjects)
+			p->nSubsteps = ChooseSubsteps(p, fElapsedTime);
+
+		for (int z = 0; z < 10; z++)		// Does 10 physics iterations/frame for accurate, controllable calculations
+		{
+			// Objects only affect one another through the events handled after the step, and only missiles explode,
+			// so stepping each type in turn comes out the same as stepping them all in list order
+			StepObjects(vecWormsInPlay, z, fElapsedTime);
+			StepObjects(vecMissilesInPlay, z, fElapsedTime);
+			StepObjects(vecDebrisInPlay, z, fElapsedTime);
+
+			HandlePhysicsEvents();		// Applies what happened during the step before the next one
+		}
+
+		UpdateObjectList();		// Removes dead objects and adds new ones, once per update
+	}
+
+	template <class T>
+	void StepObjects(const vector<T*>& vecInPlay, int z, real_t fElapsedTime)		// One of the frame's physics iterations, for every object of one type
+	{
+		for (T* p : vecInPlay)
+		{
+			if (p->bDead || p->nSubsteps == 0)		// Dead objects stay in the list until the end of the frame, but no longer move
+				continue;
+
+			int nStride = 10 / p->nSubsteps;
+			if (z % nStride != 0)		// Object is covered by a longer iteration this frame
+				continue;
+
+			StepObject(p, fElapsedTime * nStride);
+		}
+	}
+
+	template <class T>
+	void StepObject(T* p, real_t fStepTime)		// Moves one object through one substep of fStepTime
+	{
+		stats.nSubstepsLastFrame++;
+
+		// Applies gravity
+		p->ay += 2.0f;
+
+		// Updates velocity
+		p->vx += p->ax * fStepTime;
+		p->vy += p->ay * fStepTime;
+
+		// Updates potential future position
+		real_t fPotentialX = p->px + p->vx * fStepTime;
+		real_t fPotentialY = p->py + p->vy * fStepTime;
+
+		// Resets acceleration and stability
+		p->ax = 0.0f;
+		p->ay = 0.0f;
+		p->bStable = false;
+
+		// Checks colision with the map along the whole path travelled this step, not just at its end
+		real_t fResponseX = 0.0f;
+		real_t fResponseY = 0.0f;
+		real_t fFreeX = p->px;
+		real_t fFreeY = p->py;
+		bool bCollision = SweepTerrain(p, fPotentialX, fPotentialY, fResponseX, fResponseY, fFreeX, fFreeY);
+		p->bTouchingTerrain = bCollision;
+
+		// Calculates magnitudes of response and velocity vectors
+		real_t fMagVelocity = RealLength(p->vx, p->vy);
+		real_t fMagResponse = RealLength(fResponseX, fResponseY);
+
+		if (p->px < 0 || p->px > nMapWidth || p->py <0 || p->py > nMapHeight)
+		{
+			p->bDead = true;
+			PushEvent({ sPhysicsEvent::EVT_DEATH, p, p->px, p->py, 0.0f });
+		}
+
+		// Finds angle of collision
+		if (bCollision)		// If collision has occured, respond
+		{
+			// Moves up to the last point on the path that was clear of the terrain
+			p->px = fFreeX;
+			p->py = fFreeY;
+			p->bStable = true;
+
+			// Calculates reflection vector of objects velocity vector, using response vector as normal;
+			// probes can cancel each other out, leaving no normal to reflect about
+			if (fMagResponse > 0.0f)
+			{
+				real_t fNormalX = fResponseX / fMagResponse;
+				real_t fNormalY = fResponseY / fMagResponse;
+				real_t dot = p->vx * fNormalX + p->vy * fNormalY;
+
+				// Uses the friction coefficient to dampen response (approximates energy loss)
+				p->vx = p->fFriction * (-2.0f * dot * fNormalX + p->vx);
+				p->vy = p->fFriction * (-2.0f * dot * fNormalY + p->vy);
+			}
+
+			if (fMagVelocity >= 0.1f)		// Objects resting on the terrain touch it every step, which isn't news
+				PushEvent({ sPhysicsEvent::EVT_BOUNCE, p, p->px, p->py, (float)fMagVelocity });
+
+			if (p->nBounceBeforeDeath > 0)		// Makes some objects 'die' after several bounces
+			{
+				p->nBounceBeforeDeath--;
+				p->bDead = p->nBounceBeforeDeath == 0;
+
+				if (p->bDead)		// Action upon an objects death; If greater than 0, creates an explosion
+				{
+					PushEvent({ sPhysicsEvent::EVT_DEATH, p, p->px, p->py, 0.0f });
+
+					int nResponse = p->BounceDeathAction();
+					if (nResponse > 0)
+						PushEvent({ sPhysicsEvent::EVT_EXPLOSION, p, p->px, p->py, (float)nResponse });
+				}
+
+			}
+		}
+		else		// Else allow it to use the new potential positions
+		{
+			// Updates objects position with potential (x,y) coordinates
+			p->px = fPotentialX;
+			p->py = fPotentialY;
+		}
+
+		// Makes objects stop moving when velocity is low
+		if (fMagVelocity < 0.1f)
+			p->bStable = true;
+	}
+
+	void UpdateObjectList()
+	{
+		// Drops dead objects from the list in a single pass, handing their slots back to their pools
+		auto itLast = remove_if(vecObjects.begin(), vecObjects.end(), [&](cPhysicsObject* p)
+		{
+			if (!p->bDead)
+				return false;
+
+			switch (p->nType)
+			{
+			case cPhysicsObject::OBJ_DEBRIS: poolDebris.Recycle((cDebris*)p); break;
+			case cPhysicsObject::OBJ_MISSILE: poolMissiles.Recycle((cMissile*)p); break;
+			default: break;		// Worms are never reused, as teams keep pointing at them
+			}
+
+			if (p == pCameraTrackingObject)		// Don't follow an object whose slot may be reused
+				pCameraTrackingObject = nullptr;
+
+			return true;
+		});
+		vecObjects.erase(itLast, vecObjects.end());
+
+		auto EraseDead = [](auto& vecInPlay) { vecInPlay.erase(remove_if(vecInPlay.begin(), vecInPlay.end(), [](cPhysicsObject* p) { return p->bDead; }), vecInPlay.end()); };
+		EraseDead(vecWormsInPlay);
+		EraseDead(vecMissilesInPlay);
+		EraseDead(vecDebrisInPlay);
+
+		// Adds objects spawned since the last update
+		vecObjects.insert(vecObjects.end(), vecSpawned.begin(), vecSpawned.end());
+		for (cPhysicsObject* p : vecSpawned)
+			switch (p->nType)
+			{
+			case cPhysicsObject::OBJ_DEBRIS: vecDebrisInPlay.push_back((cDebris*)p); break;
+			case cPhysicsObject::OBJ_MISSILE: vecMissilesInPlay.push_back((cMissile*)p); break;
+			case cPhysicsObject::OBJ_WORM: vecWormsInPlay.push_back((cWorm*)p); break;
+			default: break;
+			}
+		vecSpawned.clear();
+	}
+
+	// Marches an object from its current position towards its potential position one pixel at a time, so fast
+	// objects can't tunnel through thin terrain between steps. Returns true on the first sample that hits terrain,
+	// with the accumulated escape response and the last sample position that was still clear
+	bool SweepTerrain(cPhysicsObject* p, real_t fPotentialX, real_t fPotentialY, real_t& fResponseX, real_t& fResponseY, real_t& fFreeX, real_t& fFreeY)
+	{
+		// Semicircle of an object's radius that's rotated towards the direction of travel; the same for every sample
+		real_t fProbeX[5];
+		real_t fProbeY[5];
+		int nProbes = 0;
+#if defined(WORMS_FIXED_POINT)
+		int nAngle = TableAtan2(p->vy.n, p->vx.n);
+		for (int r = nAngle - nAngleSteps / 4; r < nAngle + nAngleSteps / 4; r += nAngleSteps / 8)
+		{
+			fProbeX[nProbes] = p->radius * cFixed::FromRaw(TableCos(r));
+			fProbeY[nProbes] = p->radius * cFixed::FromRaw(TableSin(r));
+			nProbes++;
+		}
+#else
+		float fAngle = atan2f(p->vy, p->vx);
+		for (float r = fAngle - 3.14159f / 2.0f; r < fAngle + 3.14159f / 2.0f && nProbes < 5; r += 3.14159f / 4.0f)
+		{
+			fProbeX[nProbes] = (p->radius) * cosf(r);
+			fProbeY[nProbes] = (p->radius) * sinf(r);
+			nProbes++;
+		}
+#endif
+
+		// Terrain is stored per pixel, so samples no more than a pixel apart can't step over any of it
+		real_t fPathX = fPotentialX - p->px;
+		real_t fPathY = fPotentialY - p->py;
+		int nSamples = max(1, CeilToInt(RealLength(fPathX, fPathY)));
+
+		fFreeX = p->px;
+		fFreeY = p->py;
+
+		for (int s = 1; s <= nSamples; s++)
+		{
+			real_t fSampleX = p->px + fPathX * s / nSamples;
+			real_t fSampleY = p->py + fPathY * s / nSamples;
+			bool bCollision = false;
+
+			for (int i = 0; i < nProbes; i++)
+			{
+				// Calculates the test point on circumference of circle
+				real_t fTestPosX = fProbeX[i] + fSampleX;
+				real_t fTestPosY = fProbeY[i] + fSampleY;
+
+				// Constrains to test within the map's boundary
+				if (fTestPosX >= nMapWidth) fTestPosX = nMapWidth - 1;
+				if (fTestPosY >= nMapHeight) fTestPosY = nMapHeight - 1;
+				if (fTestPosX < 0) fTestPosX = 0;
+				if (fTestPosY < 0) fTestPosY = 0;
+
+				// Tests if any of the points on an object's semicircle intersects with the terrain
+				if (map[ToInt(fTestPosY) * nMapWidth + ToInt(fTestPosX)] > 0)
+				{
+					// Accumulates collision points to define the normal vector for escape response
+					fResponseX += fSampleX - fTestPosX;
+					fResponseY += fSampleY - fTestPosY;
+					bCollision = true;
+				}
+			}
+
+			if (bCollision)
+				return true;
+
+			fFreeX = fSampleX;
+			fFreeY = fSampleY;
+		}
+
+		return false;
 	}
 
 	// Function taken from seperate project
@@ -1319,14 +2371,879 @@ private:
 			fOutput[x] = fNoise / fScaleAcc;
 		}
 	}
+};
+
+class cThreadPool		// A fixed set of worker threads that are kept alive and given jobs, so work can be farmed out cheaply
+{
+public:
+	cThreadPool(int nThreads = 0)
+	{
+		if (nThreads <= 0)
+			nThreads = max(1, (int)thread::hardware_concurrency());
+
+		for (int i = 0; i < nThreads; i++)
+			vecThreads.emplace_back(&cThreadPool::Worker, this);
+	}
+
+	~cThreadPool()
+	{
+		{
+			unique_lock<mutex> lock(muxJobs);
+			bStop = true;
+		}
+		cvJobs.notify_all();
+
+		for (auto& t : vecThreads)
+			t.join();
+	}
+
+	void Submit(function<void()> job)		// Queues a job for the next free worker
+	{
+		{
+			unique_lock<mutex> lock(muxJobs);
+			dequeJobs.push_back(std::move(job));
+			nUnfinished++;
+		}
+		cvJobs.notify_one();
+	}
+
+	void Wait()		// Blocks until every job submitted so far has finished
+	{
+		unique_lock<mutex> lock(muxJobs);
+		cvDone.wait(lock, [&] { return nUnfinished == 0; });
+	}
+
+	int GetThreadCount() const { return (int)vecThreads.size(); }
+
+private:
+	void Worker()
+	{
+		while (true)
+		{
+			function<void()> job;
+			{
+				unique_lock<mutex> lock(muxJobs);
+				cvJobs.wait(lock, [&] { return bStop || !dequeJobs.empty(); });
+				if (dequeJobs.empty())		// Only stops once the queue has drained
+					return;
+				job = std::move(dequeJobs.front());
+				dequeJobs.pop_front();
+			}
+
+			job();
+
+			{
+				unique_lock<mutex> lock(muxJobs);
+				nUnfinished--;
+				if (nUnfinished == 0)
+					cvDone.notify_all();
+			}
+		}
+	}
+
+	vector<thread> vecThreads;
+	deque<function<void()>> dequeJobs;
+	mutex muxJobs;
+	condition_variable cvJobs;		// Signalled when a job is queued, or when stopping
+	condition_variable cvDone;		// Signalled when the last unfinished job completes
+	int nUnfinished = 0;		// Jobs queued or running
+	bool bStop = false;
+};
+
+class Worms : public olc::PixelGameEngine
+{
+public:
+	Worms(float fZoomRequested = 0.0f)		// Screen pixels per map pixel; 0 shows 400 rows of the map whatever the screen size
+	{
+		sAppName = "Worms";
+		fZoom = fZoomRequested;
+	}
+
+private:
+	friend class cWormsTest;		// Tests.cpp checks the layers and the match from inside
+
+	cMatch match;		// The game being played and shown
+
+	// For camera control
+	float fCameraPosX = 0.0f;
+	float fCameraPosY = 0.0f;
+	float fCameraPosXTarget = 0.0f;
+	float fCameraPosYTarget = 0.0f;
+
+	// The objects are drawn at one pixel per map pixel into a layer the size of the view, which the renderer
+	// stretches over the screen along with the terrain, so the drawing costs the same at any resolution
+	float fZoom = 0.0f;		// Screen pixels per map pixel up close
+	int nViewWidth = 0;		// Map pixels shown across the screen up close
+	int nViewHeight = 0;
+	int nHudScale = 1;		// The HUD is drawn at screen resolution, scaled up to stay readable on big screens
+
+	cQualityGovernor governor;		// Lowers quality when frames take too long
+	bool bShowProfiler = false;		// Displays frame statistics on screen
+
+	unique_ptr<cCompiledSprite> sprWorm;		// Sprite sheet for the worms and their tombstones, one 8x8 cell each
+	cWireFrameBatch batchWireFrames;		// Debris and missile outlines, reused every frame
+	cThreadPool poolRender;		// Draws the bands of the screen in parallel
+	vector<vector<cWorm*>> vecBandWorms;		// Worms that overlap each band of the screen
+
+	struct sEffect		// A translucent circle that drifts, grows and fades: an explosion's flash or a puff of its smoke
+	{
+		float x, y;
+		float vx, vy;		// Drift, in pixels per second
+		float fRadius;
+		float fGrowth;		// How fast the radius grows, in pixels per second
+		float fAge;
+		float fLife;		// Seconds until it has faded out completely
+		olc::Pixel col;		// Alpha is how opaque it starts
+	};
+	vector<sEffect> vecEffects;
+
+	struct sLabel		// Text that floats up from a point on the map and disappears, like the damage a worm took
+	{
+		float x, y;		// Centre of the text's bottom edge
+		string sText;
+		float fAge;
+		olc::Pixel col;
+	};
+	vector<sLabel> vecLabels;
+	cTextCache text;		// All text the game draws; labels keep their text while they float, so each is compiled once
+	mt19937 rngEffects;		// Only decides how effects look, so it's kept apart from the match's random numbers
+	olc::Pixel palTerrain[256];		// Colour of each map value, indexed by the value as an unsigned byte
+
+	// The frame is split into layers so each is only redrawn and uploaded when it changes. The engine draws layer 0
+	// last, so it holds the HUD; objects go underneath it and the terrain at the bottom
+	cLayerCache layerHud;		// Team health bars, countdown, cursor, energy bar and profiler
+	cLayerCache layerObjects;		// Worms, debris, missiles and effects
+	uint8_t nLayerTerrain = 0;		// The whole map, indexed through palTerrain. The camera only moves the layer; the map is copied in where it changes
+	vector<int> vecHudHealthBars;		// Lengths of the team health bars this frame
+
+	// Everything the renderer needs from the match, copied out at the end of a simulated frame. There are two, so
+	// one can be drawn on the engine thread while the next frame is simulated on another and published into the other
+	struct sFrameState
+	{
+		vector<cWorm> vecWorms;		// Copies of the live objects
+		vector<cDebris> vecDebris;
+		vector<cMissile> vecMissiles;
+		vector<sTerrainRect> vecTerrainChanges;
+		vector<char> vecTerrain;		// The changed regions' map values, row by row, one region after another
+		vector<sExplosion> vecExplosions;
+		vector<sWormDamage> vecWormDamage;
+		vector<float> vecTeamHealth;		// Each team's health as a share of what it started with
+
+		bool bZoomOut = false;
+		bool bShowCountDown = false;
+		float fTurnTime = 0.0f;
+		float fEnergyLevel = 0.0f;
+		bool bTracking = false;		// The camera follows an object, which is at (fTrackX, fTrackY)
+		float fTrackX = 0.0f;
+		float fTrackY = 0.0f;
+		bool bAiming = false;		// A live worm is under control, at (fAimX, fAimY) and aiming at fShootAngle
+		float fAimX = 0.0f;
+		float fAimY = 0.0f;
+		float fShootAngle = 0.0f;
+		int nObjects = 0;
+		sMatchStats stats;
+	};
+	sFrameState frames[2];
+	int nBackFrame = 0;		// The frame the simulation publishes into next
+	sFrameState* pFrame = nullptr;		// The frame being drawn
+	cThreadPool poolSimulation{ 1 };		// Simulates the next frame while this one is drawn. Declared after all it uses, so it is destroyed first
+
+	virtual bool OnUserCreate()		// Loads graphics; the match has already set itself up
+	{
+		olc::Sprite sprSheet("Sprites/worms1.png");		// Loads sprite data from sprite file
+		sprWorm.reset(new cCompiledSprite(&sprSheet, 8, 8));		// Only the runs of opaque pixels are kept
+		cWorm::SetSprite(sprWorm.get());
+		text.SetFont(GetFontSprite());
+
+		for (auto& p : palTerrain)		// Map values that are never used stay black
+			p = olc::BLACK;
+
+		// Sky radiants
+		palTerrain[(uint8_t)-8] = olc::VERY_DARK_CYAN;
+		palTerrain[(uint8_t)-7] = olc::DARK_CYAN;
+		palTerrain[(uint8_t)-6] = olc::DARK_CYAN;
+		palTerrain[(uint8_t)-5] = olc::BLUE;
+		palTerrain[(uint8_t)-4] = olc::DARK_BLUE;
+		palTerrain[(uint8_t)-3] = olc::DARK_BLUE;
+		palTerrain[(uint8_t)-2] = olc::VERY_DARK_BLUE;
+		palTerrain[(uint8_t)-1] = olc::VERY_DARK_BLUE;
+
+		// Simple sky
+		palTerrain[0] = olc::CYAN;
+
+		// Land
+		palTerrain[1] = olc::DARK_GREEN;
+
+		// Zoomed in at least far enough that the view fits in the map
+		if (fZoom <= 0.0f)
+			fZoom = ScreenHeight() / 400.0f;
+		fZoom = max(fZoom, max((float)ScreenWidth() / match.nMapWidth, (float)ScreenHeight() / match.nMapHeight));
+		nViewWidth = min((int)(ScreenWidth() / fZoom), match.nMapWidth);
+		nViewHeight = min((int)(ScreenHeight() / fZoom), match.nMapHeight);
+		nHudScale = max(1, ScreenHeight() / 400);
+
+		layerHud.Create(this, 0);
+		uint8_t nLayerObjects = CreateLayer();
+		GetLayers()[nLayerObjects].pDrawTarget.Create(nViewWidth, nViewHeight);
+		layerObjects.Create(this, nLayerObjects);
+
+		// The terrain layer is the size of the map rather than the screen; the match has already marked all of it
+		// as changed, so it's filled in on the first frame. Unless each map pixel covers a whole number of screen
+		// pixels, it's sampled filtered, so it doesn't show uneven rows and columns
+		nLayerTerrain = CreateLayer();
+		GetLayers()[nLayerTerrain].pDrawTarget.Create(match.nMapWidth, match.nMapHeight, fZoom != floorf(fZoom));
+		SetLayerPalette(nLayerTerrain, palTerrain);
+		EnableLayer(nLayerTerrain, true);
+
+		Publish(frames[nBackFrame]);		// The match as it starts is drawn while its first frame is simulated
+		return true;
+	}
+
+	virtual bool OnUserDestroy()
+	{
+		poolSimulation.Wait();
+		return true;
+	}
+
+	// Copies what the renderer needs out of the match. Runs at the end of every simulated frame, on the simulation thread
+	void Publish(sFrameState& f)
+	{
+		f.vecWorms.clear();
+		f.vecDebris.clear();
+		f.vecMissiles.clear();
+		match.poolWorms.ForEachAlive([&](cWorm& w) { f.vecWorms.push_back(w); });
+		match.poolDebris.ForEachAlive([&](cDebris& d) { f.vecDebris.push_back(d); });
+		match.poolMissiles.ForEachAlive([&](cMissile& m) { f.vecMissiles.push_back(m); });
+
+		// The lists the match keeps for its renderer are handed over; swapping keeps both sides' capacity
+		f.vecTerrainChanges.swap(match.vecTerrainChanges);
+		f.vecExplosions.swap(match.vecExplosions);
+		f.vecWormDamage.swap(match.vecWormDamage);
+		match.vecTerrainChanges.clear();
+		match.vecExplosions.clear();
+		match.vecWormDamage.clear();
+
+		f.vecTerrain.clear();
+		for (const sTerrainRect& r : f.vecTerrainChanges)
+			for (int y = r.y; y < r.y + r.h; y++)
+			{
+				const char* pRow = &match.map[y * match.nMapWidth + r.x];
+				f.vecTerrain.insert(f.vecTerrain.end(), pRow, pRow + r.w);
+			}
+
+		f.vecTeamHealth.clear();
+		for (const cTeam& team : match.vecTeams)
+		{
+			float fTotalHealth = 0.0f;
+			for (auto w : team.vecMembers)		// Accumulates team health
+				fTotalHealth += w->fHealth;
+			f.vecTeamHealth.push_back(fTotalHealth / (float)team.nTeamSize);
+		}
+
+		f.bZoomOut = match.bZoomOut;
+		f.bShowCountDown = match.bShowCountDown;
+		f.fTurnTime = match.fTurnTime;
+		f.fEnergyLevel = match.fEnergyLevel;
+
+		f.bTracking = match.pCameraTrackingObject != nullptr;
+		if (f.bTracking)
+		{
+			f.fTrackX = (float)match.pCameraTrackingObject->px;
+			f.fTrackY = (float)match.pCameraTrackingObject->py;
+		}
+
+		cWorm* worm = (cWorm*)match.pObjectUnderControl;
+		f.bAiming = worm != nullptr && !worm->bDead;
+		if (f.bAiming)
+		{
+			f.fAimX = (float)worm->px;
+			f.fAimY = (float)worm->py;
+			f.fShootAngle = (float)worm->fShootAngle;
+		}
+
+		f.nObjects = (int)match.vecObjects.size();
+		f.stats = match.stats;
+	}
+
+	void UpdateEffects(float fElapsedTime)		// Starts effects for new explosions, moves the others along and drops the faded ones
+	{
+		uniform_real_distribution<float> dist(0.0f, 1.0f);
+		for (const sExplosion& e : pFrame->vecExplosions)
+		{
+			// A bright flash that quickly swells and fades
+			vecEffects.push_back({ e.fX, e.fY, 0.0f, 0.0f, e.fRadius * 1.5f, e.fRadius * 4.0f, 0.0f, 0.15f, olc::Pixel(255, 240, 180, 200) });
+
+			int nPuffs = governor.GetSmokePuffs();
+			for (int i = 0; i < nPuffs; i++)		// Puffs of smoke that drift outwards and rise, spread around the explosion
+			{
+				float fAngle = (i + dist(rngEffects)) * 2.0f * 3.14159f / nPuffs;
+				float c = cosf(fAngle), s = sinf(fAngle);
+				vecEffects.push_back({ e.fX + c * e.fRadius * 0.5f, e.fY + s * e.fRadius * 0.5f, c * 10.0f, s * 10.0f - 15.0f,
+					e.fRadius * 0.4f, e.fRadius * 0.6f, 0.0f, 1.2f + 0.6f * dist(rngEffects), olc::Pixel(90, 90, 90, 150) });
+			}
+		}
+
+		for (sEffect& e : vecEffects)
+		{
+			e.x += e.vx * fElapsedTime;
+			e.y += e.vy * fElapsedTime;
+			e.fRadius += e.fGrowth * fElapsedTime;
+			e.fAge += fElapsedTime;
+		}
+		vecEffects.erase(remove_if(vecEffects.begin(), vecEffects.end(), [](const sEffect& e) { return e.fAge >= e.fLife; }), vecEffects.end());
+
+		olc::Pixel cols[] = { olc::RED, olc::BLUE, olc::MAGENTA, olc::GREEN };
+		for (const sWormDamage& d : pFrame->vecWormDamage)		// Damage is shown in points out of the 100 a worm starts with
+		{
+			int nPoints = (int)roundf(d.fDamage * 100.0f);
+			if (nPoints > 0)
+				vecLabels.push_back({ d.fX, d.fY - 8.0f, "-" + to_string(nPoints), 0.0f, cols[d.nTeam % 4] });
+		}
+
+		for (sLabel& l : vecLabels)
+		{
+			l.y -= 20.0f * fElapsedTime;
+			l.fAge += fElapsedTime;
+		}
+		vecLabels.erase(remove_if(vecLabels.begin(), vecLabels.end(), [](const sLabel& l) { return l.fAge >= 1.5f; }), vecLabels.end());
+	}
+
+	void DrawLabels()
+	{
+		for (const sLabel& l : vecLabels)
+		{
+			olc::vi2d vSize = cTextCache::GetTextSize(l.sText);
+			DrawText((int32_t)(l.x - fCameraPosX) - vSize.x / 2, (int32_t)(l.y - fCameraPosY) - vSize.y, l.sText, l.col);
+		}
+	}
+
+	void DrawText(int32_t x, int32_t y, const string& sText, olc::Pixel col = olc::WHITE, int nScale = 1)		// DrawString through the text cache
+	{
+		olc::Sprite* pTarget = GetDrawTarget();
+		text.Draw({ pTarget, 0, pTarget->height }, x, y, sText, col, nScale);
+		MarkDirty({ x, y }, cTextCache::GetTextSize(sText) * nScale);		// The cache writes the target's rows directly
+	}
+
+	void DrawEffects()		// Laid over the objects in their layer, keeping their translucency for the terrain underneath
+	{
+		if (vecEffects.empty())
+			return;
+
+		// ALPHA blending makes pixels opaque, which would hide the terrain. OVER composites each circle over what's
+		// already in the layer instead, giving the same colour once the layer is drawn over the terrain
+		SetPixelMode(olc::Pixel::OVER);
+		for (const sEffect& e : vecEffects)
+		{
+			olc::Pixel col = e.col;
+			col.a = (uint8_t)(e.col.a * (1.0f - e.fAge / e.fLife));
+			FillCircle((int32_t)(e.x - fCameraPosX), (int32_t)(e.y - fCameraPosY), (int32_t)e.fRadius, col);
+		}
+		SetPixelMode(olc::Pixel::NORMAL);
+	}
+
+	// Whether anything drawn within fExtent of an object's centre could be on screen in the up close view
+	bool IsInView(const cPhysicsObject& o, float fExtent)
+	{
+		float x = (float)o.px - fCameraPosX;
+		float y = (float)o.py - fCameraPosY;
+		return x + fExtent >= 0.0f && y + fExtent >= 0.0f && x - fExtent < (float)nViewWidth && y - fExtent < (float)nViewHeight;
+	}
+
+	// Copies a region of the map into the terrain layer. Map values are the layer's palette indices, so it's a byte
+	// per pixel here; the engine colours in the region just before uploading it
+	void RenderTerrain(const sTerrainRect& r, const char* pValues)		// pValues holds the region's map values row by row
+	{
+		uint8_t* pIndices = GetLayerIndices(nLayerTerrain);
+		for (int y = r.y; y < r.y + r.h; y++, pValues += r.w)
+			memcpy(pIndices + y * match.nMapWidth + r.x, pValues, r.w);
+	}
+
+	void UpdateTerrain()		// Redraws only the regions of the terrain layer that the match changed, and has the engine upload just those
+	{
+		SetDrawTarget(nLayerTerrain, false);
+		const char* pValues = pFrame->vecTerrain.data();
+		for (const sTerrainRect& r : pFrame->vecTerrainChanges)
+		{
+			RenderTerrain(r, pValues);
+			MarkDirty({ r.x, r.y }, { r.w, r.h });
+			pValues += r.w * r.h;
+		}
+		SetDrawTarget(nullptr);
+
+		// Offset and scale are in texture coordinates, where the whole map is 1 across. Zoomed out, the whole map
+		// is stretched over the screen; up close, the screen shows the camera's window of it
+		if (pFrame->bZoomOut)
+		{
+			SetLayerOffset(nLayerTerrain, 0.0f, 0.0f);
+			SetLayerScale(nLayerTerrain, 1.0f, 1.0f);
+		}
+		else
+		{
+			SetLayerOffset(nLayerTerrain, (float)(int)fCameraPosX / match.nMapWidth, (float)(int)fCameraPosY / match.nMapHeight);
+			SetLayerScale(nLayerTerrain, (float)nViewWidth / match.nMapWidth, (float)nViewHeight / match.nMapHeight);
+		}
+	}
+
+	void MarkObject(float x, float y, float fExtent)		// Tells the engine about an object drawn straight into the layer's pixels
+	{
+		// A pixel beyond the extent on each side covers coordinates being rounded towards zero
+		int x1 = (int)floorf(x - fExtent) - 1, y1 = (int)floorf(y - fExtent) - 1;
+		int x2 = (int)ceilf(x + fExtent) + 2, y2 = (int)ceilf(y + fExtent) + 2;
+		MarkDirty({ x1, y1 }, { x2 - x1, y2 - y1 });
+	}
+
+	// Draws the up close view of the objects. The screen is split into one band of rows per render thread;
+	// objects are sorted into the bands they overlap, then every band is drawn at once by its own thread
+	void DrawViewInBands()
+	{
+		int nBands = min(poolRender.GetThreadCount(), nViewHeight);
+		int nBandHeight = (nViewHeight + nBands - 1) / nBands;
+		bool bLowDetail = governor.IsLowDetail();
+
+		vecBandWorms.resize(nBands);
+		for (auto& v : vecBandWorms)
+			v.clear();
+
+		for (cWorm& w : pFrame->vecWorms)
+		{
+			if (!IsInView(w, 7.0f))		// Sprite and health bar
+				continue;
+			MarkObject((float)w.px - fCameraPosX, (float)w.py - fCameraPosY, 7.0f);
+			int nTop = (int)floorf((float)w.py - fCameraPosY - 7.0f);
+			int nBottom = (int)ceilf((float)w.py - fCameraPosY + 7.0f);
+			for (int b = max(nTop, 0) / nBandHeight; b <= min(nBottom / nBandHeight, nBands - 1); b++)
+				vecBandWorms[b].push_back(&w);
+		}
+
+		batchWireFrames.Begin(nViewWidth, nViewHeight);
+		for (cDebris& d : pFrame->vecDebris)
+			if (IsInView(d, 2.0f * d.radius))		// The rectangle's far corner, whichever way it's turned
+			{
+				MarkObject((float)d.px - fCameraPosX, (float)d.py - fCameraPosY, 2.0f * d.radius);
+				d.Draw(batchWireFrames, fCameraPosX, fCameraPosY, false, bLowDetail);
+			}
+		for (cMissile& m : pFrame->vecMissiles)
+			if (IsInView(m, 2.0f * m.radius))		// Nose and tail fins
+			{
+				MarkObject((float)m.px - fCameraPosX, (float)m.py - fCameraPosY, 2.0f * m.radius);
+				m.Draw(batchWireFrames, fCameraPosX, fCameraPosY, false, bLowDetail);
+			}
+		batchWireFrames.Bin(nBandHeight, nBands);
 
+		for (int b = 0; b < nBands; b++)
+		{
+			sBand band = { GetDrawTarget(), b * nBandHeight, min((b + 1) * nBandHeight, nViewHeight) };
+			poolRender.Submit([this, b, band, bLowDetail]()
+			{
+				for (cWorm* w : vecBandWorms[b])
+					w->Draw(band, fCameraPosX, fCameraPosY, false, bLowDetail);
+				batchWireFrames.FlushBand(this, b, band);
+			});
+		}
+		poolRender.Wait();
+	}
+
+	// The frame simulated last time round is drawn, while the match moves on to the next frame on its own thread.
+	// The match is only touched here before the simulation is started; the drawing reads the published copy
+	virtual bool OnUserUpdate(float fElapsedTime)
+	{
+		poolSimulation.Wait();
+		governor.Update(fElapsedTime);
+
+		pFrame = &frames[nBackFrame];
+		nBackFrame = 1 - nBackFrame;
+
+		// Tab key toggles between whole map view and up close view, straight away rather than a frame later
+		if (GetKey(olc::Key::TAB).bReleased)
+		{
+			match.bZoomOut = !match.bZoomOut;
+			pFrame->bZoomOut = match.bZoomOut;
+		}
+
+		// F3 key toggles the profiler overlay
+		if (GetKey(olc::Key::F3).bReleased)
+			bShowProfiler = !bShowProfiler;
+
+		/* Debugging items
+		if (GetKey(olc::Key::M).bReleased)		// Whenever 'M' key is released, generate new map
+			match.CreateMap();
+
+		if (GetMouse(0).bReleased)		// Lanches debris wherever the left mouse button is released
+			match.Boom(GetMouseX() + fCameraPosX, GetMouseY() + fCameraPosY, 10.0f);
+
+		if (GetMouse(1).bReleased)		// Drops a missile wherever the right mouse button is released
+			match.Spawn(match.poolMissiles, GetMouseX() + fCameraPosX, GetMouseY() + fCameraPosY);
+
+		if (GetMouse(2).bReleased)		// Creates a Worm/unit object wherever the middle mouse button is released
+		{
+			cWorm* worm = match.Spawn(match.poolWorms, GetMouseX() + fCameraPosX, GetMouseY() + fCameraPosY);
+			match.pObjectUnderControl = worm;
+			match.pCameraTrackingObject = worm;
+		}
+		*/
+
+		// Controller camera for mouse edge map scrolling
+		float fMapScrollSpeed = 400.0f;
+		if (GetMouseX() < 5)		// If within 5 pixels on screen edge, move camera position
+			fCameraPosX -= fMapScrollSpeed * fElapsedTime;
+		if (GetMouseX() > ScreenWidth() - 5)
+			fCameraPosX += fMapScrollSpeed * fElapsedTime;
+		if (GetMouseY() < 5)
+			fCameraPosY -= fMapScrollSpeed * fElapsedTime;
+		if (GetMouseY() > ScreenWidth() - 5)
+			fCameraPosY += fMapScrollSpeed * fElapsedTime;
+
+		// Passes the keyboard on to the match, which decides whether the player is allowed to act
+		sPlayerInput input;
+		input.bJump = GetKey(olc::Key::Z).bPressed;
+		input.bAimLeft = GetKey(olc::Key::A).bHeld;
+		input.bAimRight = GetKey(olc::Key::S).bHeld;
+		input.bFirePressed = GetKey(olc::Key::SPACE).bPressed;
+		input.bFireHeld = GetKey(olc::Key::SPACE).bHeld;
+		input.bFireReleased = GetKey(olc::Key::SPACE).bReleased;
+
+		int nFrame = nBackFrame;
+		poolSimulation.Submit([this, fElapsedTime, input, nFrame]()
+		{
+			match.Update(fElapsedTime, input);
+			Publish(frames[nFrame]);
+		});
+		UpdateEffects(fElapsedTime);
+
+		if (pFrame->bTracking)		// Move camera automatically if tracking object isn't null
+		{
+			// Makes camera's current position slowly inerpolate between current and target position
+			fCameraPosXTarget = pFrame->fTrackX - nViewWidth / 2;
+			fCameraPosYTarget = pFrame->fTrackY - nViewHeight / 2;
+			fCameraPosX += (fCameraPosXTarget - fCameraPosX) * 15.0f * fElapsedTime;
+			fCameraPosY += (fCameraPosYTarget - fCameraPosY) * 15.0f * fElapsedTime;
+		}
+
+		// Clamp map boundaries to keep camera in bounds
+		int nMapWidth = match.nMapWidth;
+		int nMapHeight = match.nMapHeight;
+		if (fCameraPosX < 0)
+			fCameraPosX = 0;
+		if (fCameraPosX >= nMapWidth - nViewWidth)
+			fCameraPosX = nMapWidth - nViewWidth;
+		if (fCameraPosY < 0)
+			fCameraPosY = 0;
+		if (fCameraPosY >= nMapHeight - nViewHeight)
+			fCameraPosY = nMapHeight - nViewHeight;
+
+		UpdateTerrain();
+		DrawObjects();
+		DrawHud();
+		text.EndFrame();
+
+		return true;
+	}
+
+	// Objects are redrawn only when something about them on screen has changed, or while effects are fading
+	void DrawObjects()
+	{
+		bool bLowDetail = governor.IsLowDetail();
+		layerObjects.Add((int)pFrame->bZoomOut);
+		layerObjects.Add((int)bLowDetail);
+		if (!pFrame->bZoomOut)
+		{
+			layerObjects.Add(fCameraPosX);
+			layerObjects.Add(fCameraPosY);
+		}
+
+		// Zoomed out, everything is on screen
+		auto bInView = [&](const cPhysicsObject& o, float fExtent) { return pFrame->bZoomOut || IsInView(o, fExtent); };
+		for (const cWorm& w : pFrame->vecWorms)
+		{
+			if (!bInView(w, 7.0f))
+				continue;
+			layerObjects.Add((float)w.px);
+			layerObjects.Add((float)w.py);
+			layerObjects.Add(w.nTeam);
+			layerObjects.Add((int)w.bIsPlayable);
+			layerObjects.Add((float)w.fHealth);
+		}
+		auto AddWireFrame = [&](const cPhysicsObject& o, int nAngle)
+		{
+			if (!bInView(o, 2.0f * o.radius))
+				return;
+			layerObjects.Add((float)o.px);
+			layerObjects.Add((float)o.py);
+			layerObjects.Add(pFrame->bZoomOut ? 0 : nAngle);		// Zoomed out they're dots, whichever way they face
+		};
+		for (const cDebris& d : pFrame->vecDebris)
+			AddWireFrame(d, bLowDetail ? 0 : ModelAngle(d.vx, d.vy));
+		for (const cMissile& m : pFrame->vecMissiles)
+			AddWireFrame(m, ModelAngle(m.vx, m.vy));
+
+		// Cursor and energy bar of the worm under control, up close
+		bool bShowCursor = !pFrame->bZoomOut && pFrame->bAiming;
+		layerObjects.Add((int)bShowCursor);
+		float cx = 0.0f, cy = 0.0f, wx = 0.0f, wy = 0.0f;
+		int nEnergy = 0;
+		if (bShowCursor)
+		{
+			// Finds centerpoint of crosshair
+			wx = pFrame->fAimX - fCameraPosX;
+			wy = pFrame->fAimY - fCameraPosY;
+			cx = wx + 8.0f * cosf(pFrame->fShootAngle);
+			cy = wy + 8.0f * sinf(pFrame->fShootAngle);
+			nEnergy = (int)ceilf(11 * pFrame->fEnergyLevel);
+			layerObjects.Add((int)cx);
+			layerObjects.Add((int)cy);
+			layerObjects.Add(wx);
+			layerObjects.Add(wy);
+			layerObjects.Add(nEnergy);
+		}
+
+		if (!layerObjects.Begin(!vecEffects.empty() || !vecLabels.empty()))
+			return;
+
+		if (!pFrame->bZoomOut)
+		{
+			DrawViewInBands();
+			DrawEffects();
+			DrawLabels();
+
+			if (bShowCursor)
+			{
+				// Draws a '+' symbol for the cursor
+				Draw(cx, cy, olc::BLACK);
+				Draw(cx + 1, cy, olc::BLACK);
+				Draw(cx - 1, cy, olc::BLACK);
+				Draw(cx, cy + 1, olc::BLACK);
+				Draw(cx, cy - 1, olc::BLACK);
+
+				for (int i = 0; i < nEnergy; i++)		// Draws an energy bar, indicating how much energy the weapon will be fired with
+				{
+					Draw(wx - 5 + i, wy - 12, olc::GREEN);
+					Draw(wx - 5 + i, wy - 11, olc::RED);
+				}
+			}
+		}
+		else
+		{
+			// Objects are placed at their map position scaled down to the view
+			float fScaleX = (float)nViewWidth / (float)match.nMapWidth;
+			float fScaleY = (float)nViewHeight / (float)match.nMapHeight;
+			olc::Sprite* pTarget = GetDrawTarget();
+			auto DrawDot = [&](const cPhysicsObject& o, olc::Pixel col)		// Debris and missiles are a single pixel at this size
+			{
+				int x = (int)((float)o.px * fScaleX);
+				int y = (int)((float)o.py * fScaleY);
+				if (x >= 0 && y >= 0 && x < pTarget->width && y < pTarget->height)
+				{
+					pTarget->GetData()[y * pTarget->width + x] = col;
+					MarkDirty({ x, y }, { 1, 1 });
+				}
+			};
+
+			sBand screen = { pTarget, 0, pTarget->height };
+			for (cWorm& w : pFrame->vecWorms)
+			{
+				float fScreenX = (float)w.px * fScaleX;
+				float fScreenY = (float)w.py * fScaleY;
+				if (fScreenX + w.radius >= 0 && fScreenY + w.radius >= 0 && fScreenX - w.radius < nViewWidth && fScreenY - w.radius < nViewHeight)
+				{
+					MarkObject(fScreenX, fScreenY, 7.0f);
+					w.Draw(screen, (float)w.px - fScreenX, (float)w.py - fScreenY, true, bLowDetail);
+				}
+			}
+			for (const cDebris& d : pFrame->vecDebris)
+				DrawDot(d, olc::DARK_GREEN);
+			for (const cMissile& m : pFrame->vecMissiles)
+				DrawDot(m, olc::BLACK);
+		}
+
+		layerObjects.End();
+	}
+
+	// The HUD is worked out first, and only drawn again when some of it has changed
+	void DrawHud()
+	{
+		vecHudHealthBars.clear();
+		for (float fHealth : pFrame->vecTeamHealth)		// Team health bar lengths
+		{
+			vecHudHealthBars.push_back((int)(fHealth * (float)(ScreenWidth() - 8 * nHudScale)));
+			layerHud.Add(vecHudHealthBars.back());
+		}
+
+		int nCountDown = -1;		// Only the last seconds of a turn are counted down
+		if (pFrame->bShowCountDown && round(pFrame->fTurnTime) < 10)
+			nCountDown = (int)round(pFrame->fTurnTime);
+		layerHud.Add(nCountDown);
+
+		layerHud.Add((int)bShowProfiler);
+		int nFrameTime = (int)(governor.GetAverageFrameTime() * 1000.0f);
+		if (bShowProfiler)
+		{
+			layerHud.Add((int)GetFPS());
+			layerHud.Add(nFrameTime);
+			layerHud.Add(pFrame->nObjects);
+			layerHud.Add(governor.GetLevel());
+			layerHud.Add(pFrame->stats.nEventsLastFrame);
+			layerHud.Add(pFrame->stats.nEventsDropped);
+			layerHud.Add(pFrame->stats.nSubstepsLastFrame);
+			layerHud.Add((int)(GetUploadedBytes() / 1024));
+		}
+
+		if (!layerHud.Begin())
+			return;
+
+		/* Marker for debugging purposes
+		if (bGameIsStable)
+			FillRect(2, 2, 4, 4, olc::RED);
+		*/
+
+		int s = nHudScale;
+		olc::Pixel cols[] = { olc::RED, olc::BLUE, olc::MAGENTA, olc::GREEN };
+		for (size_t t = 0; t < vecHudHealthBars.size(); t++)		// Draws team health bars
+			FillRect(4 * s, (4 + t * 4) * s, vecHudHealthBars[t], 3 * s, cols[t]);
+
+		if (nCountDown >= 0)		// Counts down using 7 segment display
+			SevenSegmentDisplay(4 * s, (pFrame->vecTeamHealth.size() * 4 + 8) * s, nCountDown, olc::DARK_GREY, 2 * s);
+
+		if (bShowProfiler)		// Draws frame statistics in the top right corner
+		{
+			int px = ScreenWidth() - (8 * 16 + 4) * s;
+			FillRect(px - 2 * s, 2 * s, (8 * 16 + 4) * s, (7 * 10 + 2) * s, olc::BLACK);
+			DrawText(px, 4 * s, "FPS     " + to_string(GetFPS()), olc::WHITE, s);
+			DrawText(px, 14 * s, "FRAME   " + to_string(nFrameTime) + "MS", olc::WHITE, s);
+			DrawText(px, 24 * s, "OBJECTS " + to_string(pFrame->nObjects), olc::WHITE, s);
+			DrawText(px, 34 * s, "QUALITY " + to_string(governor.GetLevel()), governor.GetLevel() == 0 ? olc::WHITE : olc::YELLOW, s);
+			DrawText(px, 44 * s, "EVENTS  " + to_string(pFrame->stats.nEventsLastFrame), pFrame->stats.nEventsDropped == 0 ? olc::WHITE : olc::RED, s);
+			DrawText(px, 54 * s, "STEPS   " + to_string(pFrame->stats.nSubstepsLastFrame), olc::WHITE, s);
+			DrawText(px, 64 * s, "UPLOAD  " + to_string(GetUploadedBytes() / 1024) + "KB", olc::WHITE, s);
+		}
+
+		layerHud.End();
+	}
+
+	void SevenSegmentDisplay(int x, int y, int digit, olc::Pixel col = olc::WHITE, int scale = 1)
+	{
+		// Encodes which segment is active per digit
+		char segmentCode[10] = {
+			// For digit '0' the segments 0, 1, 2, 4, 5, 6 are active
+			0b01110111,
+			0b00100100,
+			0b01011101,
+			0b01101101,
+			0b00101110,
+			0b01101011,
+			0b01111011,
+			0b00100101,
+			0b01111111,
+			0b01101111,
+		};
+
+		// Checks if the bit at cByte[nIndex] is set
+		auto is_bit_active = [=](char cByte, int nIndex) -> bool {
+			return ((cByte >> nIndex) & 0x01) == 0x01;
+			};
+
+		// Draws the segments in a 8x8 grid
+		if (is_bit_active(segmentCode[digit], 0)) FillRect(x + (1 * scale), y, 4 * scale, 1 * scale, col);
+		if (is_bit_active(segmentCode[digit], 1)) FillRect(x, y + (1 * scale), 1 * scale, 3 * scale, col);
+		if (is_bit_active(segmentCode[digit], 2)) FillRect(x + (5 * scale), y + (1 * scale), 1 * scale, 3 * scale, col);
+		if (is_bit_active(segmentCode[digit], 3)) FillRect(x + (1 * scale), y + (4 * scale), 4 * scale, 1 * scale, col);
+		if (is_bit_active(segmentCode[digit], 4)) FillRect(x, y + (5 * scale), 1 * scale, 3 * scale, col);
+		if (is_bit_active(segmentCode[digit], 5)) FillRect(x + (5 * scale), y + (5 * scale), 1 * scale, 3 * scale, col);
+		if (is_bit_active(segmentCode[digit], 6)) FillRect(x + (1 * scale), y + (8 * scale), 4 * scale, 1 * scale, col);
+	}
 };
 
-int main()
+// Plays nMatches computer-only matches without a window, spread over a thread pool, and reports how they went
+void SimulateMatches(int nMatches, int nThreads)
 {
-	Worms game;
-	if (game.Construct(640, 400, 2, 2))
+	struct sResult
+	{
+		int nWinningTeam = -1;
+		float fMatchTime = 0.0f;
+		bool bFinished = false;
+		sMatchStats stats;
+	};
+
+	const float fTimeStep = 1.0f / 60.0f;
+	const float fTimeLimit = 30.0f * 60.0f;		// Matches still going after half an hour of game time are called a draw
+
+	vector<sResult> vecResults(nMatches);
+	cThreadPool pool(nThreads);
+
+	auto tStart = chrono::steady_clock::now();
+	for (int i = 0; i < nMatches; i++)
+	{
+		pool.Submit([&vecResults, i, fTimeStep, fTimeLimit]
+		{
+			unique_ptr<cMatch> match(new cMatch(1 + i));		// Match number is the seed, so any result can be replayed
+			match->bHumanPlayer = false;
+
+			// Frame times wobble around 60 fps, as they do in a window. At an exactly fixed step the AI's aim can swing
+			// back and forth past its target for good, never landing close enough to fire
+			mt19937 rngFrames(1 + i);
+			uniform_real_distribution<float> distFrameTime(0.9f * fTimeStep, 1.1f * fTimeStep);
+
+			sPlayerInput input;
+			while (!match->IsOver() && match->GetMatchTime() < fTimeLimit)
+				match->Update(distFrameTime(rngFrames), input);
+
+			sResult& r = vecResults[i];
+			r.nWinningTeam = match->GetWinningTeam();
+			r.fMatchTime = match->GetMatchTime();
+			r.bFinished = match->IsOver();
+			r.stats = match->stats;
+		});
+	}
+	pool.Wait();
+	float fWallTime = chrono::duration<float>(chrono::steady_clock::now() - tStart).count();
+
+	// Sums up results per team
+	vector<int> vecWins(4, 0);
+	int nDraws = 0;
+	float fTotalMatchTime = 0.0f;
+	int nTotalExplosions = 0;
+	for (auto& r : vecResults)
+	{
+		if (r.bFinished && r.nWinningTeam >= 0 && r.nWinningTeam < (int)vecWins.size())
+			vecWins[r.nWinningTeam]++;
+		else
+			nDraws++;
+		fTotalMatchTime += r.fMatchTime;
+		nTotalExplosions += r.stats.nExplosions;
+	}
+
+	cout << nMatches << " matches on " << pool.GetThreadCount() << " threads in " << fWallTime << "s" << endl;
+	for (size_t t = 0; t < vecWins.size(); t++)
+		cout << "Team " << t << " wins: " << vecWins[t] << endl;
+	cout << "Draws: " << nDraws << endl;
+	cout << "Average match length: " << fTotalMatchTime / max(1, nMatches) << "s of game time" << endl;
+	cout << "Average explosions per match: " << (float)nTotalExplosions / max(1, nMatches) << endl;
+}
+
+#if !defined(WORMS_NO_MAIN)		// Tests.cpp builds the game in, with its own entry point
+int main(int argc, char* argv[])
+{
+	// "Worms --simulate <matches> [threads]" plays computer-only matches for balance testing instead of opening a window
+	if (argc >= 3 && string(argv[1]) == "--simulate")
+	{
+		SimulateMatches(atoi(argv[2]), argc >= 4 ? atoi(argv[3]) : 0);
+		return 0;
+	}
+
+	// "Worms --resolution <width> <height> [zoom]" opens a window of that many pixels, showing the map zoomed in by zoom
+	int nWidth = 640, nHeight = 400, nPixelSize = 2;
+	float fZoom = 0.0f;
+	if (argc >= 4 && string(argv[1]) == "--resolution")
+	{
+		nWidth = atoi(argv[2]);
+		nHeight = atoi(argv[3]);
+		nPixelSize = 1;
+		fZoom = argc >= 5 ? (float)atof(argv[4]) : 0.0f;
+	}
+
+	Worms game(fZoom);
+	if (game.Construct(nWidth, nHeight, nPixelSize, nPixelSize))
 		game.Start();
 
 	return 0;
 }
+#endif
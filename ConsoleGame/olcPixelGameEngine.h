@@ -416,6 +416,17 @@ int main()
 	#endif
 #endif
 
+#if !defined(OLC_PGE_NO_SIMD)
+	#if defined(__SSE2__) || defined(_M_X64) || defined(_M_AMD64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+		#define OLC_PGE_SSE2
+		#include <emmintrin.h>
+	#endif
+	#if defined(__AVX2__)
+		#define OLC_PGE_AVX2
+		#include <immintrin.h>
+	#endif
+#endif
+
 #if !defined(OLC_KEYBOARD_UK)
 	#define OLC_KEYBOARD_UK
 #endif
@@ -446,7 +457,9 @@ int main()
 
 #if defined(OLC_PGE_HEADLESS)
 	#define OLC_PLATFORM_HEADLESS
-	#define OLC_GFX_HEADLESS
+	#if !defined(OLC_GFX_SOFTWARE)
+		#define OLC_GFX_HEADLESS
+	#endif
 	#if !defined(OLC_IMAGE_STB) && !defined(OLC_IMAGE_GDI) && !defined(OLC_IMAGE_LIBPNG)
 		#define OLC_IMAGE_HEADLESS
 	#endif
@@ -479,7 +492,7 @@ int main()
 
 
 // Renderer
-#if !defined(OLC_GFX_OPENGL10) && !defined(OLC_GFX_OPENGL33) && !defined(OLC_GFX_DIRECTX10) && !defined(OLC_GFX_HEADLESS)
+#if !defined(OLC_GFX_OPENGL10) && !defined(OLC_GFX_OPENGL33) && !defined(OLC_GFX_DIRECTX10) && !defined(OLC_GFX_HEADLESS) && !defined(OLC_GFX_SOFTWARE)
 	#if !defined(OLC_GFX_CUSTOM_EX)
 		#if defined(OLC_PLATFORM_EMSCRIPTEN)
 			#define OLC_GFX_OPENGL33
@@ -587,7 +600,7 @@ namespace olc
 			struct { uint8_t r; uint8_t g; uint8_t b; uint8_t a; };
 		};
 
-		enum Mode { NORMAL, MASK, ALPHA, CUSTOM };
+		enum Mode { NORMAL, MASK, ALPHA, OVER, CUSTOM };
 
 		Pixel();
 		Pixel(uint8_t red, uint8_t green, uint8_t blue, uint8_t alpha = nDefaultAlpha);
@@ -897,6 +910,16 @@ namespace olc
 		uint32_t points = 0;
 	};
 
+	// Part of a layer's draw target written since it was last uploaded, from vMin up to but excluding vMax
+	struct DirtyRect
+	{
+		olc::vi2d vMin;
+		olc::vi2d vMax;
+
+		// Covers nothing, and takes the bounds of whatever it's first grown by
+		static DirtyRect Empty() { return { { INT32_MAX, INT32_MAX }, { INT32_MIN, INT32_MIN } }; }
+	};
+
 	struct LayerDesc
 	{
 		olc::vf2d vOffset = { 0, 0 };
@@ -908,6 +931,10 @@ namespace olc
 		std::vector<DecalInstance> vecDecalInstance;
 		olc::Pixel tint = olc::WHITE;
 		std::function<void()> funcHook = nullptr;
+		std::vector<DirtyRect> vecDirty;
+		DirtyRect rPlotted = DirtyRect::Empty();		// Box around pixels plotted one at a time, added to vecDirty at upload
+		std::vector<uint8_t> vecIndices;		// Indexed layers only: one palette index per pixel
+		std::vector<olc::Pixel> vecPalette;
 	};
 
 	class Renderer
@@ -924,6 +951,8 @@ namespace olc
 		virtual void       DrawDecal(const olc::DecalInstance& decal) = 0;
 		virtual uint32_t   CreateTexture(const uint32_t width, const uint32_t height, const bool filtered = false, const bool clamp = true) = 0;
 		virtual void       UpdateTexture(uint32_t id, olc::Sprite* spr) = 0;
+		// Uploads part of a sprite into a texture of the same size; renderers without sub-image updates upload it all
+		virtual void       UpdateTextureRegion(uint32_t id, olc::Sprite* spr, const olc::vi2d& pos, const olc::vi2d& size) { UpdateTexture(id, spr); }
 		virtual void       ReadTexture(uint32_t id, olc::Sprite* spr) = 0;
 		virtual uint32_t   DeleteTexture(const uint32_t id) = 0;
 		virtual void       ApplyTexture(uint32_t id) = 0;
@@ -1044,6 +1073,10 @@ namespace olc
 		void SetLayerScale(uint8_t layer, float x, float y);
 		void SetLayerTint(uint8_t layer, const olc::Pixel& tint);
 		void SetLayerCustomRenderFunction(uint8_t layer, std::function<void()> f);
+		// Makes a layer indexed: it's written as one byte per pixel through GetLayerIndices, and its dirty
+		// regions are expanded through the 256 colour palette just before upload, replacing what was drawn there
+		void SetLayerPalette(uint8_t layer, const olc::Pixel* palette);
+		uint8_t* GetLayerIndices(uint8_t layer);
 
 		std::vector<LayerDesc>& GetLayers();
 		uint32_t CreateLayer();
@@ -1052,6 +1085,7 @@ namespace olc
 		// olc::Pixel::NORMAL = No transparency
 		// olc::Pixel::MASK   = Transparent if alpha is < 255
 		// olc::Pixel::ALPHA  = Full transparency
+		// olc::Pixel::OVER   = Full transparency that leaves see-through targets see-through, for layers drawn over others
 		void SetPixelMode(Pixel::Mode m);
 		Pixel::Mode GetPixelMode();
 		// Use a custom blend function
@@ -1155,6 +1189,11 @@ namespace olc
 
 		// Dont allow PGE to mark layers as dirty, so pixel graphics don't update
 		void EnablePixelTransfer(const bool bEnable = true);
+		// Layers upload only the regions drawing functions wrote to. Code writing a layer's pixels directly
+		// must either mark what changed, or leave the layer updated with nothing marked and it is uploaded whole
+		void MarkDirty(const olc::vi2d& pos, const olc::vi2d& size);
+		// Bytes of layer pixels uploaded to the renderer for the last frame
+		uint32_t GetUploadedBytes() const;
 
 		// Command Console Routines
 		void ConsoleShow(const olc::Key &keyExit, bool bSuspendTime = true);
@@ -1175,6 +1214,14 @@ namespace olc
 		void UpdateTextEntry();
 		void UpdateConsole();
 
+		// Span rasterization: a run of pixels is clipped once, then filled by a loop specialised for the pixel mode
+		void DrawSpan(int32_t x1, int32_t x2, int32_t y, Pixel p);
+		void DrawColumn(int32_t x, int32_t y1, int32_t y2, Pixel p);
+		void BlendSprite(int32_t x, int32_t y, const Sprite* sprite, int32_t ox, int32_t oy, int32_t w, int32_t h);
+		// Adds [x1, x2) x [y1, y2) of the draw target to its layer's dirty regions
+		void MarkDirty(int32_t x1, int32_t y1, int32_t x2, int32_t y2);
+		void MergeDirty(LayerDesc& layer, const DirtyRect& r);
+
 	public:
 
 		// Experimental Lightweight 3D Routines ================
@@ -1234,6 +1281,8 @@ namespace olc
 		Renderable  fontRenderable;
 		std::vector<LayerDesc> vLayers;
 		uint8_t		nTargetLayer = 0;
+		int32_t		nDirtyLayer = -1;		// Layer whose sprite is the draw target, or -1 for any other sprite
+		uint32_t	nUploadedBytes = 0;
 		uint32_t	nLastFPS = 0;
 		bool        bPixelCohesion = false;
 		DecalMode   nDecalMode = DecalMode::NORMAL;
@@ -1982,6 +2031,9 @@ namespace olc
 		for (auto& layer : vLayers)
 		{
 			layer.pDrawTarget.Create(vScreenSize.x, vScreenSize.y);
+			if (!layer.vecIndices.empty()) layer.vecIndices.assign(size_t(w) * h, 0);
+			layer.vecDirty.clear();
+			layer.rPlotted = DirtyRect::Empty();
 			layer.bUpdate = true;
 		}
 		SetDrawTarget(nullptr);
@@ -2021,10 +2073,14 @@ namespace olc
 		if (target)
 		{
 			pDrawTarget = target;
+			nDirtyLayer = -1;
+			for (size_t i = 0; i < vLayers.size(); i++)
+				if (vLayers[i].pDrawTarget.Sprite() == target) nDirtyLayer = int32_t(i);
 		}
 		else
 		{
 			nTargetLayer = 0;
+			nDirtyLayer = 0;
 			pDrawTarget = vLayers[0].pDrawTarget.Sprite();
 		}
 	}
@@ -2036,6 +2092,7 @@ namespace olc
 			pDrawTarget = vLayers[layer].pDrawTarget.Sprite();
 			vLayers[layer].bUpdate = bDirty;
 			nTargetLayer = layer;
+			nDirtyLayer = layer;
 		}
 	}
 
@@ -2060,6 +2117,22 @@ namespace olc
 	void PixelGameEngine::SetLayerCustomRenderFunction(uint8_t layer, std::function<void()> f)
 	{ if (layer < vLayers.size()) vLayers[layer].funcHook = f; }
 
+	void PixelGameEngine::SetLayerPalette(uint8_t layer, const olc::Pixel* palette)
+	{
+		if (layer >= vLayers.size()) return;
+		LayerDesc& l = vLayers[layer];
+		olc::Sprite* spr = l.pDrawTarget.Sprite();
+		l.vecPalette.assign(palette, palette + 256);
+		l.vecIndices.resize(size_t(spr->width) * spr->height, 0);
+
+		// Any pixel may have changed colour
+		l.vecDirty.assign(1, { { 0, 0 }, { spr->width, spr->height } });
+		l.bUpdate = true;
+	}
+
+	uint8_t* PixelGameEngine::GetLayerIndices(uint8_t layer)
+	{ return layer < vLayers.size() && !vLayers[layer].vecIndices.empty() ? vLayers[layer].vecIndices.data() : nullptr; }
+
 	std::vector<LayerDesc>& PixelGameEngine::GetLayers()
 	{ return vLayers; }
 
@@ -2067,6 +2140,7 @@ namespace olc
 	{
 		LayerDesc ld;
 		ld.pDrawTarget.Create(vScreenSize.x, vScreenSize.y);
+		ld.vecDirty.reserve(8);
 		vLayers.push_back(std::move(ld));
 		return uint32_t(vLayers.size()) - 1;
 	}
@@ -2141,41 +2215,364 @@ namespace olc
 	bool PixelGameEngine::Draw(const olc::vi2d& pos, Pixel p)
 	{ return Draw(pos.x, pos.y, p); }
 
+	// Span writers, one per pixel mode, so runs of pixels are filled without checking the mode or bounds per pixel
+	namespace span
+	{
+		inline void FillRow(Pixel* pDest, int32_t nCount, Pixel p)
+		{
+			int32_t i = 0;
+#if defined(OLC_PGE_SSE2)
+			const __m128i v = _mm_set1_epi32((int)p.n);
+			for (; i + 4 <= nCount; i += 4)
+				_mm_storeu_si128((__m128i*)(pDest + i), v);
+#endif
+			for (; i < nCount; i++)
+				pDest[i] = p;
+		}
+
+		template<Pixel::Mode M> struct Writer;
+
+		template<> struct Writer<Pixel::NORMAL>
+		{
+			static void Fill(Pixel* pDest, int32_t nCount, int32_t nStride, Pixel p, float)
+			{
+				if (nStride == 1) { FillRow(pDest, nCount, p); return; }
+				for (int32_t i = 0; i < nCount; i++, pDest += nStride) *pDest = p;
+			}
+		};
+
+		template<> struct Writer<Pixel::MASK>
+		{
+			static void Fill(Pixel* pDest, int32_t nCount, int32_t nStride, Pixel p, float fBlend)
+			{
+				if (p.a == 255) Writer<Pixel::NORMAL>::Fill(pDest, nCount, nStride, p, fBlend);
+			}
+		};
+
+		// Integer alpha blending: out = (s * a + d * (255 - a)) / 255 per channel, rounded down, always opaque
+		inline uint32_t Div255(uint32_t x) { return (x + 1 + (x >> 8)) >> 8; }		// Exact for x <= 255 * 255
+
+		inline uint32_t BlendAlpha(Pixel p) { return p.a; }
+		inline uint32_t BlendAlpha(Pixel p, uint32_t nBlend) { return Div255(p.a * nBlend); }		// nBlend is the blend factor out of 255
+
+		inline Pixel Blend(Pixel s, Pixel d, uint32_t a)
+		{
+			uint32_t c = 255 - a;
+			return Pixel((uint8_t)Div255(s.r * a + d.r * c), (uint8_t)Div255(s.g * a + d.g * c), (uint8_t)Div255(s.b * a + d.b * c));
+		}
+
+#if defined(OLC_PGE_SSE2)
+		// Blends two pixels held as 16 bit channels; a and c hold each pixel's alpha and 255 - alpha in every channel
+		inline __m128i Blend16(__m128i s, __m128i d, __m128i a, __m128i c)
+		{
+			__m128i x = _mm_add_epi16(_mm_mullo_epi16(s, a), _mm_mullo_epi16(d, c));
+			return _mm_srli_epi16(_mm_add_epi16(_mm_add_epi16(x, _mm_set1_epi16(1)), _mm_srli_epi16(x, 8)), 8);
+		}
+#endif
+
+		// A run of pixels blended with one colour
+		inline void BlendRow(Pixel* pDest, int32_t nCount, int32_t nStride, Pixel p, uint32_t a)
+		{
+			int32_t i = 0;
+#if defined(OLC_PGE_SSE2)
+			if (nStride == 1)
+			{
+				const __m128i zero = _mm_setzero_si128();
+				const __m128i opaque = _mm_set1_epi32((int)0xFF000000);
+				const __m128i s = _mm_unpacklo_epi8(_mm_set1_epi32((int)p.n), zero);
+				const __m128i va = _mm_set1_epi16((short)a), vc = _mm_set1_epi16((short)(255 - a));
+				for (; i + 4 <= nCount; i += 4)
+				{
+					__m128i d = _mm_loadu_si128((const __m128i*)(pDest + i));
+					__m128i lo = Blend16(s, _mm_unpacklo_epi8(d, zero), va, vc);
+					__m128i hi = Blend16(s, _mm_unpackhi_epi8(d, zero), va, vc);
+					_mm_storeu_si128((__m128i*)(pDest + i), _mm_or_si128(_mm_packus_epi16(lo, hi), opaque));
+				}
+			}
+#endif
+			for (; i < nCount; i++)
+				pDest[i * nStride] = Blend(p, pDest[i * nStride], a);
+		}
+
+		// A run of pixels blended with a run of source pixels, each with its own alpha scaled by nBlend out of 255
+		inline void BlendRow(Pixel* pDest, const Pixel* pSource, int32_t nCount, uint32_t nBlend)
+		{
+			int32_t i = 0;
+#if defined(OLC_PGE_SSE2)
+			const __m128i zero = _mm_setzero_si128();
+			const __m128i opaque = _mm_set1_epi32((int)0xFF000000);
+			const __m128i blend = _mm_set1_epi16((short)nBlend);
+			const __m128i full = _mm_set1_epi16(255);
+			auto Half = [&](__m128i s, __m128i d)
+			{
+				// Spreads each pixel's alpha across its four channels, then scales it by the blend factor
+				__m128i a = _mm_shufflehi_epi16(_mm_shufflelo_epi16(s, _MM_SHUFFLE(3, 3, 3, 3)), _MM_SHUFFLE(3, 3, 3, 3));
+				a = Blend16(a, zero, blend, zero);
+				return Blend16(s, d, a, _mm_sub_epi16(full, a));
+			};
+			for (; i + 4 <= nCount; i += 4)
+			{
+				__m128i s = _mm_loadu_si128((const __m128i*)(pSource + i));
+				__m128i d = _mm_loadu_si128((const __m128i*)(pDest + i));
+				__m128i lo = Half(_mm_unpacklo_epi8(s, zero), _mm_unpacklo_epi8(d, zero));
+				__m128i hi = Half(_mm_unpackhi_epi8(s, zero), _mm_unpackhi_epi8(d, zero));
+				_mm_storeu_si128((__m128i*)(pDest + i), _mm_or_si128(_mm_packus_epi16(lo, hi), opaque));
+			}
+#endif
+			for (; i < nCount; i++)
+				pDest[i] = Blend(pSource[i], pDest[i], BlendAlpha(pSource[i], nBlend));
+		}
+
+		// Multiplies each channel of a run of pixels by a tint, as texture modulation does
+		inline Pixel Modulate(Pixel p, Pixel t)
+		{
+			return Pixel((uint8_t)Div255(p.r * t.r), (uint8_t)Div255(p.g * t.g), (uint8_t)Div255(p.b * t.b), (uint8_t)Div255(p.a * t.a));
+		}
+
+		inline void ModulateRow(Pixel* pDest, int32_t nCount, Pixel t)
+		{
+			int32_t i = 0;
+#if defined(OLC_PGE_SSE2)
+			const __m128i zero = _mm_setzero_si128();
+			const __m128i vt = _mm_unpacklo_epi8(_mm_set1_epi32((int)t.n), zero);
+			for (; i + 4 <= nCount; i += 4)
+			{
+				__m128i p = _mm_loadu_si128((const __m128i*)(pDest + i));
+				__m128i lo = Blend16(_mm_unpacklo_epi8(p, zero), zero, vt, zero);
+				__m128i hi = Blend16(_mm_unpackhi_epi8(p, zero), zero, vt, zero);
+				_mm_storeu_si128((__m128i*)(pDest + i), _mm_packus_epi16(lo, hi));
+			}
+#endif
+			for (; i < nCount; i++)
+				pDest[i] = Modulate(pDest[i], t);
+		}
+
+		// Additive blending: out = d + s * a / 255 per channel, saturating, always opaque
+		inline Pixel Add(Pixel s, Pixel d)
+		{
+			uint32_t a = s.a;
+			return Pixel((uint8_t)std::min(255u, d.r + Div255(s.r * a)), (uint8_t)std::min(255u, d.g + Div255(s.g * a)), (uint8_t)std::min(255u, d.b + Div255(s.b * a)));
+		}
+
+		inline void AddRow(Pixel* pDest, const Pixel* pSource, int32_t nCount)
+		{
+			int32_t i = 0;
+#if defined(OLC_PGE_SSE2)
+			const __m128i zero = _mm_setzero_si128();
+			const __m128i opaque = _mm_set1_epi32((int)0xFF000000);
+			auto Half = [&](__m128i s)
+			{
+				__m128i a = _mm_shufflehi_epi16(_mm_shufflelo_epi16(s, _MM_SHUFFLE(3, 3, 3, 3)), _MM_SHUFFLE(3, 3, 3, 3));
+				return Blend16(s, zero, a, zero);
+			};
+			for (; i + 4 <= nCount; i += 4)
+			{
+				__m128i s = _mm_loadu_si128((const __m128i*)(pSource + i));
+				__m128i d = _mm_loadu_si128((const __m128i*)(pDest + i));
+				__m128i x = _mm_packus_epi16(Half(_mm_unpacklo_epi8(s, zero)), Half(_mm_unpackhi_epi8(s, zero)));
+				_mm_storeu_si128((__m128i*)(pDest + i), _mm_or_si128(_mm_adds_epu8(d, x), opaque));
+			}
+#endif
+			for (; i < nCount; i++)
+				pDest[i] = Add(pSource[i], pDest[i]);
+		}
+
+		inline uint32_t BlendFactor(float fBlend) { return (uint32_t)(fBlend * 255.0f + 0.5f); }
+
+		// Compositing over a target that may itself be see-through: the target keeps what still shows through of it,
+		// and the colours stay straight, so the result looks the same as blending each onto whatever ends up beneath
+		inline Pixel Over(Pixel s, Pixel d, uint32_t a)
+		{
+			uint32_t b = Div255(d.a * (255 - a));
+			uint32_t nAlpha = a + b;
+			if (nAlpha == 0) return Pixel(0, 0, 0, 0);
+			return Pixel((uint8_t)((s.r * a + d.r * b) / nAlpha), (uint8_t)((s.g * a + d.g * b) / nAlpha),
+				(uint8_t)((s.b * a + d.b * b) / nAlpha), (uint8_t)nAlpha);
+		}
+
+		inline void OverRow(Pixel* pDest, int32_t nCount, int32_t nStride, Pixel p, uint32_t a)
+		{
+			int32_t i = 0;
+#if defined(OLC_PGE_SSE2)
+			if (nStride == 1)
+			{
+				// Dividing by each pixel's new alpha n is a multiply by 65536 / n, kept high, which comes out at most
+				// one short, and a check that puts that one back. Channels are 16 bits, two pixels to a register
+				static const std::array<uint16_t, 256> vecReciprocal = []()
+				{
+					std::array<uint16_t, 256> v;
+					for (uint32_t n = 0; n < 256; n++) v[n] = (uint16_t)std::min(65535u, 65536u / std::max(n, 1u));
+					return v;
+				}();
+				const __m128i zero = _mm_setzero_si128(), one = _mm_set1_epi16(1);
+				const __m128i alpha = _mm_set_epi16(-1, 0, 0, 0, -1, 0, 0, 0);
+				const __m128i sa = _mm_mullo_epi16(_mm_unpacklo_epi8(_mm_set1_epi32((int)p.n), zero), _mm_set1_epi16((short)a));
+				const __m128i va = _mm_set1_epi16((short)a), vc = _mm_set1_epi16((short)(255 - a));
+				auto Half = [&](__m128i d)
+				{
+					__m128i da = _mm_shufflehi_epi16(_mm_shufflelo_epi16(d, _MM_SHUFFLE(3, 3, 3, 3)), _MM_SHUFFLE(3, 3, 3, 3));
+					__m128i b = Blend16(da, zero, vc, zero);
+					__m128i n = _mm_add_epi16(va, b);
+					__m128i x = _mm_add_epi16(sa, _mm_mullo_epi16(d, b));
+					uint16_t m0 = vecReciprocal[_mm_extract_epi16(n, 0)], m1 = vecReciprocal[_mm_extract_epi16(n, 4)];
+					__m128i q = _mm_mulhi_epu16(x, _mm_set_epi16(m1, m1, m1, m1, m0, m0, m0, m0));
+					__m128i nNext = _mm_mullo_epi16(_mm_add_epi16(q, one), _mm_max_epi16(n, one));
+					q = _mm_sub_epi16(q, _mm_cmpeq_epi16(_mm_subs_epu16(nNext, x), zero));
+					return _mm_or_si128(_mm_andnot_si128(alpha, q), _mm_and_si128(alpha, n));
+				};
+				for (; i + 4 <= nCount; i += 4)
+				{
+					__m128i d = _mm_loadu_si128((const __m128i*)(pDest + i));
+					__m128i lo = Half(_mm_unpacklo_epi8(d, zero)), hi = Half(_mm_unpackhi_epi8(d, zero));
+					_mm_storeu_si128((__m128i*)(pDest + i), _mm_packus_epi16(lo, hi));
+				}
+			}
+#endif
+			for (; i < nCount; i++)
+				pDest[i * nStride] = Over(p, pDest[i * nStride], a);
+		}
+
+		// Looks a run of palette indices up into colours. AVX2 widens eight indices and gathers their colours in one
+		// instruction. SSE2 has no gather, so four indices are read as one word, looked up, and stored as one 128-bit write
+		inline void ExpandRow(Pixel* pDest, const uint8_t* pSource, int32_t nCount, const Pixel* pPalette)
+		{
+			int32_t i = 0;
+#if defined(OLC_PGE_AVX2)
+			for (; i + 8 <= nCount; i += 8)
+			{
+				__m256i nIndices = _mm256_cvtepu8_epi32(_mm_loadl_epi64((const __m128i*)(pSource + i)));
+				_mm256_storeu_si256((__m256i*)(pDest + i), _mm256_i32gather_epi32((const int*)pPalette, nIndices, 4));
+			}
+#endif
+#if defined(OLC_PGE_SSE2)
+			for (; i + 4 <= nCount; i += 4)
+			{
+				uint32_t nIndices;
+				std::memcpy(&nIndices, pSource + i, 4);
+				_mm_storeu_si128((__m128i*)(pDest + i), _mm_setr_epi32((int)pPalette[nIndices & 0xFF].n, (int)pPalette[(nIndices >> 8) & 0xFF].n,
+					(int)pPalette[(nIndices >> 16) & 0xFF].n, (int)pPalette[nIndices >> 24].n));
+			}
+#endif
+			for (; i < nCount; i++)
+				pDest[i] = pPalette[pSource[i]];
+		}
+
+		template<> struct Writer<Pixel::ALPHA>
+		{
+			static void Fill(Pixel* pDest, int32_t nCount, int32_t nStride, Pixel p, float fBlend)
+			{
+				BlendRow(pDest, nCount, nStride, p, BlendAlpha(p, BlendFactor(fBlend)));
+			}
+		};
+
+		template<> struct Writer<Pixel::OVER>
+		{
+			static void Fill(Pixel* pDest, int32_t nCount, int32_t nStride, Pixel p, float fBlend)
+			{
+				OverRow(pDest, nCount, nStride, p, BlendAlpha(p, BlendFactor(fBlend)));
+			}
+		};
+	}
+
 	// This is it, the critical function that plots a pixel
 	bool PixelGameEngine::Draw(int32_t x, int32_t y, Pixel p)
 	{
 		if (!pDrawTarget) return false;
 
+		bool bDrawn = false;
 		if (nPixelMode == Pixel::NORMAL)
 		{
-			return pDrawTarget->SetPixel(x, y, p);
+			bDrawn = pDrawTarget->SetPixel(x, y, p);
 		}
-
-		if (nPixelMode == Pixel::MASK)
+		else if (nPixelMode == Pixel::MASK)
 		{
 			if (p.a == 255)
-				return pDrawTarget->SetPixel(x, y, p);
+				bDrawn = pDrawTarget->SetPixel(x, y, p);
 		}
-
-		if (nPixelMode == Pixel::ALPHA)
+		else if (nPixelMode == Pixel::ALPHA)
+		{
+			// Same integer arithmetic as the span and sprite blending paths
+			Pixel d = pDrawTarget->GetPixel(x, y);
+			bDrawn = pDrawTarget->SetPixel(x, y, span::Blend(p, d, span::BlendAlpha(p, span::BlendFactor(fBlendFactor))));
+		}
+		else if (nPixelMode == Pixel::OVER)
 		{
 			Pixel d = pDrawTarget->GetPixel(x, y);
-			float a = (float)(p.a / 255.0f) * fBlendFactor;
-			float c = 1.0f - a;
-			float r = a * (float)p.r + c * (float)d.r;
-			float g = a * (float)p.g + c * (float)d.g;
-			float b = a * (float)p.b + c * (float)d.b;
-			return pDrawTarget->SetPixel(x, y, Pixel((uint8_t)r, (uint8_t)g, (uint8_t)b/*, (uint8_t)(p.a * fBlendFactor)*/));
+			bDrawn = pDrawTarget->SetPixel(x, y, span::Over(p, d, span::BlendAlpha(p, span::BlendFactor(fBlendFactor))));
+		}
+		else if (nPixelMode == Pixel::CUSTOM)
+		{
+			bDrawn = pDrawTarget->SetPixel(x, y, funcPixelMode(x, y, p, pDrawTarget->GetPixel(x, y)));
 		}
 
-		if (nPixelMode == Pixel::CUSTOM)
+		// Marking every pixel would cost more than plotting it, so they only grow a box the upload adds
+		if (bDrawn && nDirtyLayer >= 0)
 		{
-			return pDrawTarget->SetPixel(x, y, funcPixelMode(x, y, p, pDrawTarget->GetPixel(x, y)));
+			LayerDesc& layer = vLayers[nDirtyLayer];
+			layer.rPlotted.vMin = { std::min(x, layer.rPlotted.vMin.x), std::min(y, layer.rPlotted.vMin.y) };
+			layer.rPlotted.vMax = { std::max(x + 1, layer.rPlotted.vMax.x), std::max(y + 1, layer.rPlotted.vMax.y) };
+			layer.bUpdate = true;
 		}
+		return bDrawn;
+	}
 
-		return false;
+
+	void PixelGameEngine::DrawSpan(int32_t x1, int32_t x2, int32_t y, Pixel p)
+	{
+		if (!pDrawTarget || y < 0 || y >= pDrawTarget->height) return;
+		if (x1 < 0) x1 = 0;
+		if (x2 >= pDrawTarget->width) x2 = pDrawTarget->width - 1;
+		if (x1 > x2) return;
+
+		MarkDirty(x1, y, x2 + 1, y + 1);
+		Pixel* pDest = pDrawTarget->GetData() + y * pDrawTarget->width + x1;
+		int32_t nCount = x2 - x1 + 1;
+		switch (nPixelMode)
+		{
+		case Pixel::NORMAL: span::Writer<Pixel::NORMAL>::Fill(pDest, nCount, 1, p, fBlendFactor); break;
+		case Pixel::MASK: span::Writer<Pixel::MASK>::Fill(pDest, nCount, 1, p, fBlendFactor); break;
+		case Pixel::ALPHA: span::Writer<Pixel::ALPHA>::Fill(pDest, nCount, 1, p, fBlendFactor); break;
+		case Pixel::OVER: span::Writer<Pixel::OVER>::Fill(pDest, nCount, 1, p, fBlendFactor); break;
+		default: for (int32_t x = x1; x <= x2; x++) Draw(x, y, p); break;
+		}
 	}
 
+	void PixelGameEngine::BlendSprite(int32_t x, int32_t y, const Sprite* sprite, int32_t ox, int32_t oy, int32_t w, int32_t h)
+	{
+		if (!pDrawTarget) return;
+
+		// Clips the region once against both the draw target and the sprite; pixels outside the sprite are blank anyway
+		int32_t i1 = std::max({ 0, -x, -ox }), i2 = std::min({ w, pDrawTarget->width - x, sprite->width - ox });
+		int32_t j1 = std::max({ 0, -y, -oy }), j2 = std::min({ h, pDrawTarget->height - y, sprite->height - oy });
+		if (i1 >= i2 || j1 >= j2) return;
+
+		MarkDirty(x + i1, y + j1, x + i2, y + j2);
+		uint32_t nBlend = span::BlendFactor(fBlendFactor);
+		for (int32_t j = j1; j < j2; j++)
+			span::BlendRow(pDrawTarget->GetData() + (y + j) * pDrawTarget->width + x + i1,
+				sprite->pColData.data() + (oy + j) * sprite->width + ox + i1, i2 - i1, nBlend);
+	}
+
+	void PixelGameEngine::DrawColumn(int32_t x, int32_t y1, int32_t y2, Pixel p)
+	{
+		if (!pDrawTarget || x < 0 || x >= pDrawTarget->width) return;
+		if (y1 < 0) y1 = 0;
+		if (y2 >= pDrawTarget->height) y2 = pDrawTarget->height - 1;
+		if (y1 > y2) return;
+
+		MarkDirty(x, y1, x + 1, y2 + 1);
+		Pixel* pDest = pDrawTarget->GetData() + y1 * pDrawTarget->width + x;
+		int32_t nCount = y2 - y1 + 1;
+		int32_t nStride = pDrawTarget->width;
+		switch (nPixelMode)
+		{
+		case Pixel::NORMAL: span::Writer<Pixel::NORMAL>::Fill(pDest, nCount, nStride, p, fBlendFactor); break;
+		case Pixel::MASK: span::Writer<Pixel::MASK>::Fill(pDest, nCount, nStride, p, fBlendFactor); break;
+		case Pixel::ALPHA: span::Writer<Pixel::ALPHA>::Fill(pDest, nCount, nStride, p, fBlendFactor); break;
+		case Pixel::OVER: span::Writer<Pixel::OVER>::Fill(pDest, nCount, nStride, p, fBlendFactor); break;
+		default: for (int32_t y = y1; y <= y2; y++) Draw(x, y, p); break;
+		}
+	}
 
 	void PixelGameEngine::DrawLine(const olc::vi2d& pos1, const olc::vi2d& pos2, Pixel p, uint32_t pattern)
 	{ DrawLine(pos1.x, pos1.y, pos2.x, pos2.y, p, pattern); }
@@ -2192,11 +2589,13 @@ namespace olc
 			return;
 		x1 = p1.x; y1 = p1.y;
 		x2 = p2.x; y2 = p2.y;
+		MarkDirty(std::min(x1, x2), std::min(y1, y2), std::max(x1, x2) + 1, std::max(y1, y2) + 1);
 
 		// straight lines idea by gurkanctn
 		if (dx == 0) // Line is vertical
 		{
 			if (y2 < y1) std::swap(y1, y2);
+			if (pattern == 0xFFFFFFFF) { DrawColumn(x1, y1, y2, p); return; }
 			for (y = y1; y <= y2; y++) if (rol()) Draw(x1, y, p);
 			return;
 		}
@@ -2204,6 +2603,7 @@ namespace olc
 		if (dy == 0) // Line is horizontal
 		{
 			if (x2 < x1) std::swap(x1, x2);
+			if (pattern == 0xFFFFFFFF) { DrawSpan(x1, x2, y1, p); return; }
 			for (x = x1; x <= x2; x++) if (rol()) Draw(x, y1, p);
 			return;
 		}
@@ -2273,6 +2673,7 @@ namespace olc
 		if (radius < 0 || x < -radius || y < -radius || x - GetDrawTargetWidth() > radius || y - GetDrawTargetHeight() > radius)
 			return;
 
+		MarkDirty(x - radius, y - radius, x + radius + 1, y + radius + 1);
 		if (radius > 0)
 		{
 			int x0 = 0;
@@ -2320,8 +2721,7 @@ namespace olc
 
 			auto drawline = [&](int sx, int ex, int y)
 			{
-				for (int x = sx; x <= ex; x++)
-					Draw(x, y, p);
+				DrawSpan(sx, ex, y, p);
 			};
 
 			while (y0 >= x0)
@@ -2343,7 +2743,7 @@ namespace olc
 			}
 		}
 		else
-			Draw(x, y, p);
+			DrawSpan(x, x, y, p);
 	}
 
 	void PixelGameEngine::DrawRect(const olc::vi2d& pos, const olc::vi2d& size, Pixel p)
@@ -2361,7 +2761,8 @@ namespace olc
 	{
 		int pixels = GetDrawTargetWidth() * GetDrawTargetHeight();
 		Pixel* m = GetDrawTarget()->GetData();
-		for (int i = 0; i < pixels; i++) m[i] = p;
+		span::FillRow(m, pixels, p);
+		MarkDirty(0, 0, GetDrawTargetWidth(), GetDrawTargetHeight());
 	}
 
 	void PixelGameEngine::ClearBuffer(Pixel p, bool bDepth)
@@ -2408,6 +2809,46 @@ namespace olc
 		bSuspendTextureTransfer = !bEnable;
 	}
 
+	void PixelGameEngine::MarkDirty(const olc::vi2d& pos, const olc::vi2d& size)
+	{ MarkDirty(pos.x, pos.y, pos.x + size.x, pos.y + size.y); }
+
+	void PixelGameEngine::MarkDirty(int32_t x1, int32_t y1, int32_t x2, int32_t y2)
+	{
+		if (nDirtyLayer < 0) return;
+		x1 = std::max(x1, 0); y1 = std::max(y1, 0);
+		x2 = std::min(x2, pDrawTarget->width); y2 = std::min(y2, pDrawTarget->height);
+		if (x1 >= x2 || y1 >= y2) return;
+		vLayers[nDirtyLayer].bUpdate = true;
+		MergeDirty(vLayers[nDirtyLayer], { { x1, y1 }, { x2, y2 } });
+	}
+
+	void PixelGameEngine::MergeDirty(LayerDesc& layer, const DirtyRect& q)
+	{
+		// Grows the first region this one touches, swallowing any others the result now covers. A
+		// handful of regions keeps separate corners of the screen apart without per-upload overhead
+		int32_t x1 = q.vMin.x, y1 = q.vMin.y, x2 = q.vMax.x, y2 = q.vMax.y;
+		std::vector<DirtyRect>& vecDirty = layer.vecDirty;
+		auto Touches = [&](const DirtyRect& r) { return x1 <= r.vMax.x && x2 >= r.vMin.x && y1 <= r.vMax.y && y2 >= r.vMin.y; };
+		auto Contains = [](const DirtyRect& r, const DirtyRect& q) { return q.vMin.x >= r.vMin.x && q.vMin.y >= r.vMin.y && q.vMax.x <= r.vMax.x && q.vMax.y <= r.vMax.y; };
+
+		auto it = std::find_if(vecDirty.rbegin(), vecDirty.rend(), Touches);
+		if (it == vecDirty.rend() && vecDirty.size() < 8)
+		{
+			vecDirty.push_back({ { x1, y1 }, { x2, y2 } });
+			return;
+		}
+
+		DirtyRect& r = it != vecDirty.rend() ? *it : vecDirty.back();
+		if (x1 >= r.vMin.x && y1 >= r.vMin.y && x2 <= r.vMax.x && y2 <= r.vMax.y) return;
+		r = { { std::min(x1, r.vMin.x), std::min(y1, r.vMin.y) }, { std::max(x2, r.vMax.x), std::max(y2, r.vMax.y) } };
+		DirtyRect grown = r;
+		vecDirty.erase(std::remove_if(vecDirty.begin(), vecDirty.end(), [&](const DirtyRect& q) { return Contains(grown, q); }), vecDirty.end());
+		vecDirty.push_back(grown);
+	}
+
+	uint32_t PixelGameEngine::GetUploadedBytes() const
+	{ return nUploadedBytes; }
+
 
 	void PixelGameEngine::FillRect(const olc::vi2d& pos, const olc::vi2d& size, Pixel p)
 	{ FillRect(pos.x, pos.y, size.x, size.y, p); }
@@ -2427,9 +2868,8 @@ namespace olc
 		if (y2 < 0) y2 = 0;
 		if (y2 >= (int32_t)GetDrawTargetHeight()) y2 = (int32_t)GetDrawTargetHeight();
 
-		for (int i = x; i < x2; i++)
-			for (int j = y; j < y2; j++)
-				Draw(i, j, p);
+		for (int j = y; j < y2; j++)
+			DrawSpan(x, x2 - 1, j, p);
 	}
 
 	void PixelGameEngine::DrawTriangle(const olc::vi2d& pos1, const olc::vi2d& pos2, const olc::vi2d& pos3, Pixel p)
@@ -2448,7 +2888,7 @@ namespace olc
 	// https://www.avrfreaks.net/sites/default/files/triangles.c
 	void PixelGameEngine::FillTriangle(int32_t x1, int32_t y1, int32_t x2, int32_t y2, int32_t x3, int32_t y3, Pixel p)
 	{
-		auto drawline = [&](int sx, int ex, int ny) { for (int i = sx; i <= ex; i++) Draw(i, ny, p); };
+		auto drawline = [&](int sx, int ex, int ny) { DrawSpan(sx, ex, ny, p); };
 
 		int t1x, t2x, y, minx, maxx, t1xp, t2xp;
 		bool changed1 = false;
@@ -2591,6 +3031,8 @@ namespace olc
 		if (p3.y < p1.y){std::swap(p1.y, p3.y); std::swap(p1.x, p3.x); std::swap(vTex[0].x, vTex[2].x); std::swap(vTex[0].y, vTex[2].y); std::swap(vColour[0], vColour[2]);}
 		if (p3.y < p2.y){std::swap(p2.y, p3.y); std::swap(p2.x, p3.x); std::swap(vTex[1].x, vTex[2].x); std::swap(vTex[1].y, vTex[2].y); std::swap(vColour[1], vColour[2]);}
 
+		MarkDirty(std::min({ p1.x, p2.x, p3.x }), p1.y, std::max({ p1.x, p2.x, p3.x }) + 1, p3.y + 1);
+
 		olc::vi2d dPos1 = p2 - p1;
 		olc::vf2d dTex1 = vTex[1] - vTex[0];
 		int dcr1 = vColour[1].r - vColour[0].r;
@@ -2751,6 +3193,13 @@ namespace olc
 		if (sprite == nullptr)
 			return;
 
+		if (nPixelMode == Pixel::ALPHA && scale == 1 && flip == olc::Sprite::NONE)
+		{
+			BlendSprite(x, y, sprite, 0, 0, sprite->width, sprite->height);
+			return;
+		}
+
+		MarkDirty(x, y, x + sprite->width * int32_t(scale), y + sprite->height * int32_t(scale));
 		int32_t fxs = 0, fxm = 1, fx = 0;
 		int32_t fys = 0, fym = 1, fy = 0;
 		if (flip & olc::Sprite::Flip::HORIZ) { fxs = sprite->width - 1; fxm = -1; }
@@ -2788,6 +3237,13 @@ namespace olc
 		if (sprite == nullptr)
 			return;
 
+		if (nPixelMode == Pixel::ALPHA && scale == 1 && flip == olc::Sprite::NONE)
+		{
+			BlendSprite(x, y, sprite, ox, oy, w, h);
+			return;
+		}
+
+		MarkDirty(x, y, x + w * int32_t(scale), y + h * int32_t(scale));
 		int32_t fxs = 0, fxm = 1, fx = 0;
 		int32_t fys = 0, fym = 1, fy = 0;
 		if (flip & olc::Sprite::Flip::HORIZ) { fxs = w - 1; fxm = -1; }
@@ -3338,6 +3794,7 @@ namespace olc
 			if (col.a != 255)		SetPixelMode(Pixel::ALPHA);
 			else					SetPixelMode(Pixel::MASK);
 		}
+		MarkDirty({ x, y }, GetTextSize(sText) * int32_t(scale));
 		for (auto c : sText)
 		{
 			if (c == '\n')
@@ -3406,6 +3863,7 @@ namespace olc
 			if (col.a != 255)		SetPixelMode(Pixel::ALPHA);
 			else					SetPixelMode(Pixel::MASK);
 		}
+		MarkDirty({ x, y }, GetTextSizeProp(sText) * int32_t(scale));
 		for (auto c : sText)
 		{
 			if (c == '\n')
@@ -3876,6 +4334,9 @@ namespace olc
 			UpdateTextEntry();
 		}
 
+		// Layer 0 is uploaded every frame, unless the frame opts out with SetDrawTarget(0, false)
+		vLayers[0].bUpdate = true;
+
 		// Handle Frame Update
 		bool bExtensionBlockFrame = false;		
 		for (auto& ext : vExtensions) bExtensionBlockFrame |= ext->OnBeforeUserUpdate(fElapsedTime);
@@ -3899,10 +4360,10 @@ namespace olc
 		renderer->ClearBuffer(olc::BLACK, true);
 
 		// Layer 0 must always exist
-		vLayers[0].bUpdate = true;
 		vLayers[0].bShow = true;
 		SetDecalMode(DecalMode::NORMAL);
 		renderer->PrepareDrawing();
+		nUploadedBytes = 0;
 
 		for (auto layer = vLayers.rbegin(); layer != vLayers.rend(); ++layer)
 		{
@@ -3913,7 +4374,28 @@ namespace olc
 					renderer->ApplyTexture(layer->pDrawTarget.Decal()->id);
 					if (!bSuspendTextureTransfer && layer->bUpdate)
 					{
-						layer->pDrawTarget.Decal()->Update();
+						// Only the regions drawn to since the last upload are sent. A layer updated without any
+						// marked region or plotted pixel was written some other way, so all of it is
+						olc::Decal* pDecal = layer->pDrawTarget.Decal();
+						if (layer->rPlotted.vMin.x < layer->rPlotted.vMax.x)
+							MergeDirty(*layer, layer->rPlotted);
+						else if (layer->vecDirty.empty())
+							layer->vecDirty.push_back({ { 0, 0 }, { pDecal->sprite->width, pDecal->sprite->height } });
+						for (auto& r : layer->vecDirty)
+						{
+							olc::vi2d vSize = r.vMax - r.vMin;
+							if (!layer->vecIndices.empty())
+							{
+								olc::Sprite* spr = pDecal->sprite;
+								for (int32_t y = r.vMin.y; y < r.vMax.y; y++)
+									span::ExpandRow(spr->GetData() + y * spr->width + r.vMin.x, layer->vecIndices.data() + y * spr->width + r.vMin.x,
+										vSize.x, layer->vecPalette.data());
+							}
+							renderer->UpdateTextureRegion(pDecal->id, pDecal->sprite, r.vMin, vSize);
+							nUploadedBytes += uint32_t(vSize.x * vSize.y * sizeof(olc::Pixel));
+						}
+						layer->vecDirty.clear();
+						layer->rPlotted = DirtyRect::Empty();
 						layer->bUpdate = false;
 					}
 
@@ -4070,6 +4552,7 @@ namespace olc
 		virtual void       DrawDecal(const olc::DecalInstance& decal) {}
 		virtual uint32_t   CreateTexture(const uint32_t width, const uint32_t height, const bool filtered = false, const bool clamp = true) {return 1;};
 		virtual void       UpdateTexture(uint32_t id, olc::Sprite* spr) {}
+		virtual void       UpdateTextureRegion(uint32_t id, olc::Sprite* spr, const olc::vi2d& pos, const olc::vi2d& size) {}
 		virtual void       ReadTexture(uint32_t id, olc::Sprite* spr) {}
 		virtual uint32_t   DeleteTexture(const uint32_t id) {return 1;}
 		virtual void       ApplyTexture(uint32_t id) {}
@@ -4095,6 +4578,502 @@ namespace olc
 }
 #pragma endregion
 
+#pragma region renderer_software
+// O------------------------------------------------------------------------------O
+// | START RENDERER: Software, composites on the CPU                              |
+// O------------------------------------------------------------------------------O
+// Composites layers and decals into a framebuffer in system memory, one pixel per
+// screen pixel, so the whole pipeline can run, be benchmarked and be captured on
+// machines without a GPU. #define OLC_GFX_SOFTWARE to select it; it pairs with
+// OLC_PGE_HEADLESS in place of the headless renderer, which draws nothing.
+#if defined(OLC_GFX_SOFTWARE)
+namespace olc
+{
+	class Renderer_Software : public olc::Renderer
+	{
+	public:
+		Renderer_Software() { ptrActive = this; }
+		~Renderer_Software() { if (ptrActive == this) ptrActive = nullptr; }
+
+		// The last composited frame, valid from DisplayFrame() until the next frame clears it
+		static const olc::Sprite* GetFrameBuffer() { return ptrActive != nullptr ? &ptrActive->sprFrame : nullptr; }
+
+	private:
+		struct sTexture
+		{
+			int32_t nWidth = 0;
+			int32_t nHeight = 0;
+			std::vector<olc::Pixel> vecData;
+			bool bFiltered = false;
+			bool bClamp = true;
+			bool bInUse = false;
+		};
+
+		// Screen position plus the attributes interpolated across a triangle
+		enum { U, V, W, R, G, B, A, ATTRIBS };
+		struct sVertex
+		{
+			float x, y;
+			float f[ATTRIBS];
+		};
+
+		static Renderer_Software* ptrActive;
+		olc::Sprite sprFrame;
+		std::vector<sTexture> vecTextures;		// Texture ids are slot + 1, so id 0 means untextured
+		uint32_t nApplied = 0;
+		olc::DecalMode nDecalMode = olc::DecalMode::NORMAL;
+		std::vector<olc::Pixel> vecRow;			// One span of shaded source pixels, ready to blend
+		std::vector<int32_t> vecColumns;		// Source column for each screen column of a layer quad
+
+		struct sFilterTap		// The two texels a filtered sample falls between, and how far it is towards the second, out of 256
+		{
+			int32_t i0, i1;
+			uint32_t w;
+		};
+		std::vector<sFilterTap> vecTaps;		// Filtered layer quads: the taps for each screen column
+
+		sTexture* GetTexture(uint32_t id)
+		{
+			return (id > 0 && id <= vecTextures.size() && vecTextures[id - 1].bInUse) ? &vecTextures[id - 1] : nullptr;
+		}
+
+		static int32_t Address(int32_t i, int32_t n, bool bClamp)
+		{
+			if (bClamp) return std::min(std::max(i, 0), n - 1);
+			i %= n;
+			return i < 0 ? i + n : i;
+		}
+
+		static olc::Pixel Fetch(const sTexture& t, int32_t x, int32_t y)
+		{
+			return t.vecData[Address(y, t.nHeight, t.bClamp) * t.nWidth + Address(x, t.nWidth, t.bClamp)];
+		}
+
+		// Samples at normalised coordinates, nearest or bilinear depending on how the texture was created
+		static olc::Pixel Sample(const sTexture& t, float u, float v)
+		{
+			if (!t.bFiltered)
+				return Fetch(t, (int32_t)std::floor(u * t.nWidth), (int32_t)std::floor(v * t.nHeight));
+
+			float fx = u * t.nWidth - 0.5f, fy = v * t.nHeight - 0.5f;
+			float x0 = std::floor(fx), y0 = std::floor(fy);
+			uint32_t wx = (uint32_t)((fx - x0) * 256.0f), wy = (uint32_t)((fy - y0) * 256.0f);
+			int32_t ix = (int32_t)x0, iy = (int32_t)y0;
+			olc::Pixel p00 = Fetch(t, ix, iy), p10 = Fetch(t, ix + 1, iy), p01 = Fetch(t, ix, iy + 1), p11 = Fetch(t, ix + 1, iy + 1);
+			auto Lerp = [&](uint8_t c00, uint8_t c10, uint8_t c01, uint8_t c11)
+			{
+				uint32_t top = c00 * (256 - wx) + c10 * wx, bottom = c01 * (256 - wx) + c11 * wx;
+				return (uint8_t)((top * (256 - wy) + bottom * wy) >> 16);
+			};
+			return olc::Pixel(Lerp(p00.r, p10.r, p01.r, p11.r), Lerp(p00.g, p10.g, p01.g, p11.g),
+				Lerp(p00.b, p10.b, p01.b, p11.b), Lerp(p00.a, p10.a, p01.a, p11.a));
+		}
+
+		static sFilterTap Tap(float f, int32_t n, bool bClamp)		// f is in texels
+		{
+			float f0 = std::floor(f - 0.5f);
+			return { Address((int32_t)f0, n, bClamp), Address((int32_t)f0 + 1, n, bClamp), (uint32_t)((f - 0.5f - f0) * 256.0f) };
+		}
+
+		// A row of bilinear samples between two texture rows, wy of the way to the second. Blends down the
+		// columns first, then across, each step rounding down
+		static void FilterRow(olc::Pixel* pDest, const olc::Pixel* pRow0, const olc::Pixel* pRow1, uint32_t wy, const sFilterTap* pTaps, int32_t nCount)
+		{
+#if defined(OLC_PGE_SSE2)
+			// Two texels side by side as 16 bit channels; every product stays below 65536
+			const __m128i zero = _mm_setzero_si128();
+			const __m128i vy = _mm_set1_epi16((short)wy), vyc = _mm_set1_epi16((short)(256 - wy));
+			for (int32_t x = 0; x < nCount; x++)
+			{
+				const sFilterTap& t = pTaps[x];
+				__m128i top = _mm_unpacklo_epi8(_mm_unpacklo_epi32(_mm_cvtsi32_si128((int)pRow0[t.i0].n), _mm_cvtsi32_si128((int)pRow0[t.i1].n)), zero);
+				__m128i bottom = _mm_unpacklo_epi8(_mm_unpacklo_epi32(_mm_cvtsi32_si128((int)pRow1[t.i0].n), _mm_cvtsi32_si128((int)pRow1[t.i1].n)), zero);
+				__m128i v = _mm_srli_epi16(_mm_add_epi16(_mm_mullo_epi16(top, vyc), _mm_mullo_epi16(bottom, vy)), 8);
+				short w = (short)t.w, wc = (short)(256 - t.w);
+				__m128i h = _mm_mullo_epi16(v, _mm_set_epi16(w, w, w, w, wc, wc, wc, wc));
+				h = _mm_srli_epi16(_mm_add_epi16(h, _mm_srli_si128(h, 8)), 8);
+				pDest[x].n = (uint32_t)_mm_cvtsi128_si32(_mm_packus_epi16(h, h));
+			}
+#else
+			for (int32_t x = 0; x < nCount; x++)
+			{
+				const sFilterTap& t = pTaps[x];
+				olc::Pixel p00 = pRow0[t.i0], p10 = pRow0[t.i1], p01 = pRow1[t.i0], p11 = pRow1[t.i1];
+				auto Lerp = [&](uint8_t c00, uint8_t c10, uint8_t c01, uint8_t c11)
+				{
+					uint32_t c0 = (c00 * (256 - wy) + c01 * wy) >> 8, c1 = (c10 * (256 - wy) + c11 * wy) >> 8;
+					return (uint8_t)((c0 * (256 - t.w) + c1 * t.w) >> 8);
+				};
+				pDest[x] = olc::Pixel(Lerp(p00.r, p10.r, p01.r, p11.r), Lerp(p00.g, p10.g, p01.g, p11.g),
+					Lerp(p00.b, p10.b, p01.b, p11.b), Lerp(p00.a, p10.a, p01.a, p11.a));
+			}
+#endif
+		}
+
+		static uint8_t Channel(float f) { return (uint8_t)std::min(std::max(f + 0.5f, 0.0f), 255.0f); }
+
+		// Blends a span of source pixels into the framebuffer with the current decal mode
+		void BlendSpan(olc::Pixel* pDest, const olc::Pixel* pSource, int32_t nCount)
+		{
+			using namespace olc::span;
+			switch (nDecalMode)
+			{
+			case olc::DecalMode::ADDITIVE:
+				AddRow(pDest, pSource, nCount);
+				break;
+			case olc::DecalMode::MULTIPLICATIVE:
+				for (int32_t i = 0; i < nCount; i++)
+				{
+					olc::Pixel s = pSource[i], d = pDest[i];
+					uint32_t c = 255 - s.a;
+					pDest[i] = olc::Pixel((uint8_t)std::min(255u, Div255(d.r * (s.r + c))), (uint8_t)std::min(255u, Div255(d.g * (s.g + c))), (uint8_t)std::min(255u, Div255(d.b * (s.b + c))));
+				}
+				break;
+			case olc::DecalMode::STENCIL:
+				for (int32_t i = 0; i < nCount; i++)
+					pDest[i] = Modulate(pDest[i], olc::Pixel(pSource[i].a, pSource[i].a, pSource[i].a, 255));
+				break;
+			case olc::DecalMode::ILLUMINATE:
+				for (int32_t i = 0; i < nCount; i++)
+					pDest[i] = Blend(pDest[i], pSource[i], pSource[i].a);
+				break;
+			default:
+				BlendRow(pDest, pSource, nCount, 255);
+				break;
+			}
+		}
+
+		// Shades one span of a triangle into vecRow, then blends it. f holds the attributes at the first pixel
+		void ShadeSpan(olc::Pixel* pDest, int32_t nCount, float* f, const float* dfdx, const sTexture* pTex, bool bAffine, bool bFlatTint)
+		{
+			vecRow.resize(nCount);
+			olc::Pixel* pRow = vecRow.data();
+
+			if (pTex == nullptr)
+			{
+				if (bFlatTint)
+				{
+					olc::Pixel t(Channel(f[R]), Channel(f[G]), Channel(f[B]), Channel(f[A]));
+					if (nDecalMode == olc::DecalMode::NORMAL || nDecalMode == olc::DecalMode::WIREFRAME)
+					{
+						olc::span::BlendRow(pDest, nCount, 1, t, t.a);
+						return;
+					}
+					olc::span::FillRow(pRow, nCount, t);
+				}
+				else
+				{
+					for (int32_t i = 0; i < nCount; i++)
+						pRow[i] = olc::Pixel(Channel(f[R] + dfdx[R] * i), Channel(f[G] + dfdx[G] * i), Channel(f[B] + dfdx[B] * i), Channel(f[A] + dfdx[A] * i));
+				}
+				BlendSpan(pDest, pRow, nCount);
+				return;
+			}
+
+			if (bAffine && !pTex->bFiltered)
+			{
+				// Nearest sampling of an affine mapping steps through texels in 16.16 fixed point
+				int64_t u = (int64_t)(f[U] * pTex->nWidth * 65536.0f), du = (int64_t)(dfdx[U] * pTex->nWidth * 65536.0f);
+				int64_t v = (int64_t)(f[V] * pTex->nHeight * 65536.0f), dv = (int64_t)(dfdx[V] * pTex->nHeight * 65536.0f);
+				for (int32_t i = 0; i < nCount; i++, u += du, v += dv)
+					pRow[i] = Fetch(*pTex, (int32_t)(u >> 16), (int32_t)(v >> 16));
+			}
+			else if (bAffine)
+			{
+				for (int32_t i = 0; i < nCount; i++)
+					pRow[i] = Sample(*pTex, f[U] + dfdx[U] * i, f[V] + dfdx[V] * i);
+			}
+			else
+			{
+				for (int32_t i = 0; i < nCount; i++)
+				{
+					float q = 1.0f / (f[W] + dfdx[W] * i);
+					pRow[i] = Sample(*pTex, (f[U] + dfdx[U] * i) * q, (f[V] + dfdx[V] * i) * q);
+				}
+			}
+
+			if (bFlatTint)
+			{
+				olc::Pixel t(Channel(f[R]), Channel(f[G]), Channel(f[B]), Channel(f[A]));
+				if (t != olc::WHITE) olc::span::ModulateRow(pRow, nCount, t);
+			}
+			else
+			{
+				for (int32_t i = 0; i < nCount; i++)
+					pRow[i] = olc::span::Modulate(pRow[i], olc::Pixel(Channel(f[R] + dfdx[R] * i), Channel(f[G] + dfdx[G] * i), Channel(f[B] + dfdx[B] * i), Channel(f[A] + dfdx[A] * i)));
+			}
+			BlendSpan(pDest, pRow, nCount);
+		}
+
+		// Fills pixels whose centres fall inside the triangle, half open on the right and bottom edges
+		// so triangles sharing an edge never cover a pixel twice
+		void DrawTriangle(const sVertex& a, const sVertex& b, const sVertex& c, const sTexture* pTex, bool bAffine, bool bFlatTint)
+		{
+			const sVertex* v[3] = { &a, &b, &c };
+			if (v[1]->y < v[0]->y) std::swap(v[0], v[1]);
+			if (v[2]->y < v[1]->y) std::swap(v[1], v[2]);
+			if (v[1]->y < v[0]->y) std::swap(v[0], v[1]);
+			const sVertex& v0 = *v[0]; const sVertex& v1 = *v[1]; const sVertex& v2 = *v[2];
+
+			float fArea = (v1.x - v0.x) * (v2.y - v0.y) - (v2.x - v0.x) * (v1.y - v0.y);
+			if (std::abs(fArea) < 1e-6f) return;
+
+			// Attributes are planes over the screen, so each pixel steps by a constant gradient
+			float dfdx[ATTRIBS], dfdy[ATTRIBS], f[ATTRIBS];
+			for (int k = 0; k < ATTRIBS; k++)
+			{
+				float d1 = v1.f[k] - v0.f[k], d2 = v2.f[k] - v0.f[k];
+				dfdx[k] = (d1 * (v2.y - v0.y) - d2 * (v1.y - v0.y)) / fArea;
+				dfdy[k] = (d2 * (v1.x - v0.x) - d1 * (v2.x - v0.x)) / fArea;
+			}
+
+			int32_t nWidth = sprFrame.width, nHeight = sprFrame.height;
+			int32_t y1 = std::max(0, (int32_t)std::ceil(v0.y - 0.5f)), y2 = std::min(nHeight, (int32_t)std::ceil(v2.y - 0.5f));
+			float fLong = (v2.x - v0.x) / (v2.y - v0.y);
+			for (int32_t y = y1; y < y2; y++)
+			{
+				float yc = y + 0.5f;
+				float xa = v0.x + (yc - v0.y) * fLong;
+				float xb = yc < v1.y
+					? v0.x + (yc - v0.y) * (v1.x - v0.x) / (v1.y - v0.y)
+					: v1.x + (yc - v1.y) * (v2.x - v1.x) / (v2.y - v1.y);
+				if (xb < xa) std::swap(xa, xb);
+
+				int32_t x1 = std::max(0, (int32_t)std::ceil(xa - 0.5f)), x2 = std::min(nWidth, (int32_t)std::ceil(xb - 0.5f));
+				if (x1 >= x2) continue;
+
+				float xc = x1 + 0.5f;
+				for (int k = 0; k < ATTRIBS; k++)
+					f[k] = v0.f[k] + dfdx[k] * (xc - v0.x) + dfdy[k] * (yc - v0.y);
+				ShadeSpan(sprFrame.GetData() + y * nWidth + x1, x2 - x1, f, dfdx, pTex, bAffine, bFlatTint);
+			}
+		}
+
+		// One pixel wide line through pixel centres, blended like everything else
+		void DrawLine(const sVertex& a, const sVertex& b, const sTexture* pTex)
+		{
+			auto Colour = [&](const sVertex& s)
+			{
+				olc::Pixel p(Channel(s.f[R]), Channel(s.f[G]), Channel(s.f[B]), Channel(s.f[A]));
+				return pTex != nullptr ? olc::span::Modulate(Sample(*pTex, s.f[U] / s.f[W], s.f[V] / s.f[W]), p) : p;
+			};
+			olc::Pixel p = Colour(a);
+
+			float dx = b.x - a.x, dy = b.y - a.y;
+			int32_t nSteps = (int32_t)std::ceil(std::max(std::abs(dx), std::abs(dy)));
+			float sx = nSteps > 0 ? dx / nSteps : 0.0f, sy = nSteps > 0 ? dy / nSteps : 0.0f;
+			float x = a.x, y = a.y;
+			for (int32_t i = 0; i <= nSteps; i++, x += sx, y += sy)
+			{
+				int32_t px = (int32_t)std::floor(x), py = (int32_t)std::floor(y);
+				if (px >= 0 && px < sprFrame.width && py >= 0 && py < sprFrame.height)
+				{
+					olc::Pixel* pDest = sprFrame.GetData() + py * sprFrame.width + px;
+					*pDest = olc::span::Blend(p, *pDest, p.a);
+				}
+			}
+		}
+
+	public:
+		void PrepareDevice() override {}
+		olc::rcode CreateDevice(std::vector<void*> params, bool bFullScreen, bool bVSYNC) override { return olc::rcode::OK; }
+		olc::rcode DestroyDevice() override { vecTextures.clear(); return olc::rcode::OK; }
+		void DisplayFrame() override {}
+
+		void PrepareDrawing() override
+		{
+			nDecalMode = olc::DecalMode::NORMAL;
+		}
+
+		void SetDecalMode(const olc::DecalMode& mode) override
+		{
+			nDecalMode = mode;
+		}
+
+		// The quad covers the whole framebuffer; offset and scale move and stretch its texture coordinates
+		void DrawLayerQuad(const olc::vf2d& offset, const olc::vf2d& scale, const olc::Pixel tint) override
+		{
+			const sTexture* pTex = GetTexture(nApplied);
+			if (pTex == nullptr || pTex->vecData.empty() || sprFrame.pColData.empty()) return;
+
+			int32_t nWidth = sprFrame.width, nHeight = sprFrame.height;
+			bool bDirect = pTex->nWidth == nWidth && pTex->nHeight == nHeight && offset.x == 0.0f && offset.y == 0.0f && scale.x == 1.0f && scale.y == 1.0f;
+			bool bTint = tint != olc::WHITE;
+			vecRow.resize(nWidth);
+
+			if (!bDirect && !pTex->bFiltered)
+			{
+				vecColumns.resize(nWidth);
+				for (int32_t x = 0; x < nWidth; x++)
+					vecColumns[x] = Address((int32_t)std::floor((((x + 0.5f) / nWidth) * scale.x + offset.x) * pTex->nWidth), pTex->nWidth, pTex->bClamp);
+			}
+			else if (!bDirect)
+			{
+				vecTaps.resize(nWidth);
+				for (int32_t x = 0; x < nWidth; x++)
+					vecTaps[x] = Tap((((x + 0.5f) / nWidth) * scale.x + offset.x) * pTex->nWidth, pTex->nWidth, pTex->bClamp);
+			}
+
+			for (int32_t y = 0; y < nHeight; y++)
+			{
+				olc::Pixel* pDest = sprFrame.GetData() + y * nWidth;
+				const olc::Pixel* pSource = vecRow.data();
+				float v = ((y + 0.5f) / nHeight) * scale.y + offset.y;
+
+				if (bDirect)
+				{
+					pSource = pTex->vecData.data() + y * nWidth;
+					if (bTint) std::memcpy(vecRow.data(), pSource, nWidth * sizeof(olc::Pixel));
+				}
+				else if (!pTex->bFiltered)
+				{
+					const olc::Pixel* pTexRow = pTex->vecData.data() + Address((int32_t)std::floor(v * pTex->nHeight), pTex->nHeight, pTex->bClamp) * pTex->nWidth;
+					for (int32_t x = 0; x < nWidth; x++)
+						vecRow[x] = pTexRow[vecColumns[x]];
+				}
+				else
+				{
+					sFilterTap ty = Tap(v * pTex->nHeight, pTex->nHeight, pTex->bClamp);
+					FilterRow(vecRow.data(), pTex->vecData.data() + ty.i0 * pTex->nWidth, pTex->vecData.data() + ty.i1 * pTex->nWidth, ty.w, vecTaps.data(), nWidth);
+				}
+
+				if (bTint)
+				{
+					olc::span::ModulateRow(vecRow.data(), nWidth, tint);
+					pSource = vecRow.data();
+				}
+				olc::span::BlendRow(pDest, pSource, nWidth, 255);
+			}
+		}
+
+		void DrawDecal(const olc::DecalInstance& decal) override
+		{
+			SetDecalMode(decal.mode);
+			if (decal.mode == olc::DecalMode::MODEL3D || decal.points == 0 || sprFrame.pColData.empty()) return;
+
+			const sTexture* pTex = decal.decal != nullptr ? GetTexture(decal.decal->id) : nullptr;
+
+			// Normalised device coordinates to framebuffer pixels
+			std::vector<sVertex> vecVerts(decal.points);
+			bool bAffine = true, bFlatTint = true;
+			for (uint32_t n = 0; n < decal.points; n++)
+			{
+				sVertex& v = vecVerts[n];
+				v.x = (decal.pos[n].x + 1.0f) * 0.5f * sprFrame.width;
+				v.y = (1.0f - decal.pos[n].y) * 0.5f * sprFrame.height;
+				v.f[U] = decal.uv[n].x; v.f[V] = decal.uv[n].y; v.f[W] = decal.w[n];
+				v.f[R] = decal.tint[n].r; v.f[G] = decal.tint[n].g; v.f[B] = decal.tint[n].b; v.f[A] = decal.tint[n].a;
+				bAffine &= decal.w[n] == decal.w[0];
+				bFlatTint &= decal.tint[n] == decal.tint[0];
+			}
+
+			// With a constant w the perspective divide is the same everywhere, so it is done once per vertex
+			if (bAffine)
+				for (auto& v : vecVerts) { v.f[U] /= v.f[W]; v.f[V] /= v.f[W]; v.f[W] = 1.0f; }
+
+			if (decal.mode == olc::DecalMode::WIREFRAME || decal.structure == olc::DecalStructure::LINE)
+			{
+				for (uint32_t n = 0; n + 1 < decal.points; n++)
+					DrawLine(vecVerts[n], vecVerts[n + 1], pTex);
+				if (decal.mode == olc::DecalMode::WIREFRAME && decal.points > 2)
+					DrawLine(vecVerts[decal.points - 1], vecVerts[0], pTex);
+				return;
+			}
+
+			switch (decal.structure)
+			{
+			case olc::DecalStructure::FAN:
+				for (uint32_t n = 1; n + 1 < decal.points; n++)
+					DrawTriangle(vecVerts[0], vecVerts[n], vecVerts[n + 1], pTex, bAffine, bFlatTint);
+				break;
+			case olc::DecalStructure::STRIP:
+				for (uint32_t n = 0; n + 2 < decal.points; n++)
+					DrawTriangle(vecVerts[n], vecVerts[n + 1], vecVerts[n + 2], pTex, bAffine, bFlatTint);
+				break;
+			case olc::DecalStructure::LIST:
+				for (uint32_t n = 0; n + 2 < decal.points; n += 3)
+					DrawTriangle(vecVerts[n], vecVerts[n + 1], vecVerts[n + 2], pTex, bAffine, bFlatTint);
+				break;
+			default:
+				break;
+			}
+		}
+
+		uint32_t CreateTexture(const uint32_t width, const uint32_t height, const bool filtered, const bool clamp) override
+		{
+			size_t nSlot = 0;
+			while (nSlot < vecTextures.size() && vecTextures[nSlot].bInUse) nSlot++;
+			if (nSlot == vecTextures.size()) vecTextures.emplace_back();
+
+			sTexture& t = vecTextures[nSlot];
+			t.nWidth = width; t.nHeight = height;
+			t.vecData.assign(width * height, olc::BLANK);
+			t.bFiltered = filtered; t.bClamp = clamp; t.bInUse = true;
+			return uint32_t(nSlot + 1);
+		}
+
+		void UpdateTexture(uint32_t id, olc::Sprite* spr) override
+		{
+			sTexture* t = GetTexture(id);
+			if (t == nullptr) return;
+			t->nWidth = spr->width; t->nHeight = spr->height;
+			t->vecData.assign(spr->pColData.begin(), spr->pColData.end());
+		}
+
+		void UpdateTextureRegion(uint32_t id, olc::Sprite* spr, const olc::vi2d& pos, const olc::vi2d& size) override
+		{
+			sTexture* t = GetTexture(id);
+			if (t == nullptr) return;
+			if (t->nWidth != spr->width || t->nHeight != spr->height) { UpdateTexture(id, spr); return; }
+			for (int32_t y = pos.y; y < pos.y + size.y; y++)
+				std::memcpy(t->vecData.data() + y * t->nWidth + pos.x, spr->pColData.data() + y * spr->width + pos.x, size.x * sizeof(olc::Pixel));
+		}
+
+		void ReadTexture(uint32_t id, olc::Sprite* spr) override
+		{
+			sTexture* t = GetTexture(id);
+			if (t == nullptr) return;
+			spr->width = t->nWidth; spr->height = t->nHeight;
+			spr->pColData = t->vecData;
+		}
+
+		uint32_t DeleteTexture(const uint32_t id) override
+		{
+			sTexture* t = GetTexture(id);
+			if (t != nullptr) *t = sTexture();
+			return id;
+		}
+
+		void ApplyTexture(uint32_t id) override
+		{
+			nApplied = id;
+		}
+
+		// The framebuffer always matches the screen, whatever the window's viewport is
+		void UpdateViewport(const olc::vi2d& pos, const olc::vi2d& size) override
+		{
+			const olc::vi2d& vScreen = ptrPGE->GetScreenSize();
+			if (sprFrame.width != vScreen.x || sprFrame.height != vScreen.y)
+			{
+				sprFrame.width = vScreen.x; sprFrame.height = vScreen.y;
+				sprFrame.pColData.assign(vScreen.x * vScreen.y, olc::BLACK);
+			}
+		}
+
+		void ClearBuffer(olc::Pixel p, bool bDepth) override
+		{
+			olc::span::FillRow(sprFrame.GetData(), (int32_t)sprFrame.pColData.size(), p);
+		}
+	};
+
+	Renderer_Software* Renderer_Software::ptrActive = nullptr;
+}
+#endif
+// O------------------------------------------------------------------------------O
+// | END RENDERER: Software                                                       |
+// O------------------------------------------------------------------------------O
+#pragma endregion
+
 // O------------------------------------------------------------------------------O
 // | olcPixelGameEngine Renderers - the draw-y bits                               |
 // O------------------------------------------------------------------------------O
@@ -4528,6 +5507,14 @@ namespace olc
 			glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, spr->width, spr->height, 0, GL_RGBA, GL_UNSIGNED_BYTE, spr->GetData());
 		}
 
+		void UpdateTextureRegion(uint32_t id, olc::Sprite* spr, const olc::vi2d& pos, const olc::vi2d& size) override
+		{
+			UNUSED(id);
+			glPixelStorei(GL_UNPACK_ROW_LENGTH, spr->width);
+			glTexSubImage2D(GL_TEXTURE_2D, 0, pos.x, pos.y, size.x, size.y, GL_RGBA, GL_UNSIGNED_BYTE, spr->GetData() + pos.y * spr->width + pos.x);
+			glPixelStorei(GL_UNPACK_ROW_LENGTH, 0);
+		}
+
 		void ReadTexture(uint32_t id, olc::Sprite* spr) override
 		{
 			glReadPixels(0, 0, spr->width, spr->height, GL_RGBA, GL_UNSIGNED_BYTE, spr->GetData());
@@ -5068,6 +6055,13 @@ namespace olc
 			glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, spr->width, spr->height, 0, GL_RGBA, GL_UNSIGNED_BYTE, spr->GetData());
 		}
 
+		void UpdateTextureRegion(uint32_t id, olc::Sprite* spr, const olc::vi2d& pos, const olc::vi2d& size) override
+		{
+			// GLES2 has no unpack row length, so whole rows are sent; they are contiguous in the sprite
+			UNUSED(id);
+			glTexSubImage2D(GL_TEXTURE_2D, 0, 0, pos.y, spr->width, size.y, GL_RGBA, GL_UNSIGNED_BYTE, spr->GetData() + pos.y * spr->width);
+		}
+
 		void ReadTexture(uint32_t id, olc::Sprite* spr) override
 		{
 			glReadPixels(0, 0, spr->width, spr->height, GL_RGBA, GL_UNSIGNED_BYTE, spr->GetData());
@@ -6652,6 +7646,10 @@ namespace olc
 		renderer = std::make_unique<olc::Renderer_Headless>();
 #endif
 
+#if defined(OLC_GFX_SOFTWARE)
+		renderer = std::make_unique<olc::Renderer_Software>();
+#endif
+
 #if defined(OLC_GFX_OPENGL10)
 		renderer = std::make_unique<olc::Renderer_OGL10>();
 #endif